@@ -11,7 +11,7 @@ if %ERRORLEVEL% NEQ 0 (
 )
 
 echo Компиляция программы...
-g++ main.cpp -o github-manager.exe -std=c++17
+g++ main.cpp -o github-manager.exe -std=c++17 -lwinhttp
 
 if %ERRORLEVEL% NEQ 0 (
     echo.
@@ -19,197 +19,6047 @@
 #include <codecvt>
 #include <functional>
 #include <iomanip>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <deque>
+#include <random>
+#include <string_view>
+#include <cstdint>
+#include <charconv>
+#include <ctime>
+#include <cstring>
 #include <windows.h>
 #include <shobjidl.h>
 #include <shlobj.h>
 #include <commdlg.h>
 #include <objbase.h>
+#include <winhttp.h>
+#include <conio.h>
+#include <io.h>
+
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+
+// Индекс веток в памяти с инкрементальным нечетким поиском
+class RefIndex {
+public:
+    struct Match {
+        uint32_t index;
+        int score;
+    };
+
+    // Загрузка из вывода "git for-each-ref --format=%(committerdate:unix)|%(refname)"
+    void load(const std::string& forEachRefOutput) {
+        names.clear();
+        lowerPool.clear();
+        offsets.clear();
+        masks.clear();
+        times.clear();
+        remoteFlags.clear();
+
+        std::istringstream stream(forEachRefOutput);
+        std::string line;
+        const std::string headsPrefix = "refs/heads/";
+        const std::string remotesPrefix = "refs/remotes/";
+
+        while (std::getline(stream, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+
+            size_t sep = line.find('|');
+            if (sep == std::string::npos) {
+                continue;
+            }
+
+            std::string refName = line.substr(sep + 1);
+            bool remote = false;
+            if (refName.compare(0, headsPrefix.size(), headsPrefix) == 0) {
+                refName.erase(0, headsPrefix.size());
+            } else if (refName.compare(0, remotesPrefix.size(), remotesPrefix) == 0) {
+                refName.erase(0, remotesPrefix.size());
+                remote = true;
+            } else {
+                continue;
+            }
+
+            // Символическая ссылка origin/HEAD не является веткой
+            if (remote && refName.size() >= 5 && refName.compare(refName.size() - 5, 5, "/HEAD") == 0) {
+                continue;
+            }
+
+            long long committedAt = 0;
+            try {
+                committedAt = std::stoll(line.substr(0, sep));
+            } catch (const std::exception&) {
+                committedAt = 0;
+            }
+
+            offsets.push_back(static_cast<uint32_t>(lowerPool.size()));
+            uint64_t mask = 0;
+            for (char c : refName) {
+                char lower = toLowerAscii(c);
+                lowerPool.push_back(lower);
+                mask |= charMask(lower);
+            }
+
+            names.push_back(refName);
+            masks.push_back(mask);
+            times.push_back(committedAt);
+            remoteFlags.push_back(remote ? 1 : 0);
+        }
+        offsets.push_back(static_cast<uint32_t>(lowerPool.size()));
+    }
+
+    size_t size() const { return names.size(); }
+    const std::string& name(uint32_t i) const { return names[i]; }
+    long long committedAt(uint32_t i) const { return times[i]; }
+    bool isRemote(uint32_t i) const { return remoteFlags[i] != 0; }
+
+    // Поиск по запросу. Если передан результат для префикса запроса, поиск идет только по нему:
+    // каждое совпадение для "abc" обязательно является совпадением для "ab"
+    std::vector<Match> search(const std::string& query, const std::vector<Match>* narrowFrom = nullptr) const {
+        std::vector<Match> result;
+        std::string lowerQuery;
+        uint64_t queryMask = 0;
+        for (char c : query) {
+            lowerQuery.push_back(toLowerAscii(c));
+            queryMask |= charMask(lowerQuery.back());
+        }
+
+        if (narrowFrom != nullptr) {
+            for (const Match& previous : *narrowFrom) {
+                if ((masks[previous.index] & queryMask) != queryMask) {
+                    continue;
+                }
+                int score = fuzzyScore(lowerName(previous.index), lowerQuery);
+                if (score >= 0) {
+                    result.push_back({previous.index, score});
+                }
+            }
+        } else {
+            // Предварительный фильтр по битовым маскам символов: плотный цикл без ветвлений
+            // над непрерывным массивом, который компилятор векторизует
+            std::vector<uint8_t> passed(masks.size());
+            for (size_t i = 0; i < masks.size(); i++) {
+                passed[i] = static_cast<uint8_t>((masks[i] & queryMask) == queryMask);
+            }
+
+            for (size_t i = 0; i < masks.size(); i++) {
+                if (!passed[i]) {
+                    continue;
+                }
+                int score = fuzzyScore(lowerName(static_cast<uint32_t>(i)), lowerQuery);
+                if (score >= 0) {
+                    result.push_back({static_cast<uint32_t>(i), score});
+                }
+            }
+        }
+
+        // Сначала лучшие совпадения, при равенстве - недавно обновленные ветки
+        std::sort(result.begin(), result.end(), [this](const Match& a, const Match& b) {
+            if (a.score != b.score) {
+                return a.score > b.score;
+            }
+            return times[a.index] > times[b.index];
+        });
+        return result;
+    }
+
+    // Оценка совпадения запроса как подпоследовательности имени (-1, если не совпадает)
+    static int fuzzyScore(std::string_view name, std::string_view query) {
+        if (query.empty()) {
+            return 0;
+        }
+
+        int best = -1;
+        // Перебираем возможные начала совпадения и выбираем лучшее
+        for (size_t start = name.find(query[0]); start != std::string_view::npos;
+             start = name.find(query[0], start + 1)) {
+            int score = 0;
+            size_t q = 0;
+            size_t previousMatch = std::string_view::npos;
+
+            for (size_t n = start; n < name.size() && q < query.size(); n++) {
+                if (name[n] != query[q]) {
+                    continue;
+                }
+
+                score += 1;
+                if (n == 0 || isWordBoundary(name[n - 1])) {
+                    score += 8;
+                }
+                if (previousMatch != std::string_view::npos) {
+                    if (previousMatch + 1 == n) {
+                        score += 5;
+                    } else {
+                        score -= static_cast<int>(std::min<size_t>(n - previousMatch - 1, 3));
+                    }
+                }
+                previousMatch = n;
+                q++;
+            }
+
+            if (q < query.size()) {
+                break; // Более поздние начала тоже не дадут полного совпадения
+            }
+            if (start == 0) {
+                score += 10;
+            }
+            if (score > best) {
+                best = score;
+            }
+        }
+
+        return best;
+    }
 
-// Класс для управления GitHub репозиториями
-class GitHubManager {
 private:
-    std::wstring username;
-    std::wstring email;
-    bool isAuthenticated = false;
-    std::wstring currentDirectory; // Текущая рабочая директория
+    std::vector<std::string> names;
+    std::string lowerPool;          // Имена в нижнем регистре, расположенные подряд
+    std::vector<uint32_t> offsets;  // Начало каждого имени в lowerPool (+ конечная граница)
+    std::vector<uint64_t> masks;    // Множество символов каждого имени
+    std::vector<long long> times;   // Время последнего коммита
+    std::vector<uint8_t> remoteFlags;
 
-    // Выполнение команды в командной строке
-    std::string executeCommand(const std::string& command) {
+    std::string_view lowerName(uint32_t i) const {
+        return std::string_view(lowerPool.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    static char toLowerAscii(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    static bool isWordBoundary(char c) {
+        return c == '/' || c == '-' || c == '_' || c == '.';
+    }
+
+    static uint64_t charMask(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (u >= 'a' && u <= 'z') {
+            return 1ULL << (u - 'a');
+        }
+        if (u >= '0' && u <= '9') {
+            return 1ULL << (26 + u - '0');
+        }
+        return 1ULL << (36 + u % 28);
+    }
+};
+
+// Последовательное чтение записей, разделенных NUL (вывод git с ключом -z), без копирования
+class NulRecordReader {
+public:
+    explicit NulRecordReader(std::string_view data) : data(data) {}
+
+    bool next(std::string_view& record) {
+        if (pos >= data.size()) {
+            return false;
+        }
+        size_t end = data.find('\0', pos);
+        if (end == std::string_view::npos) {
+            end = data.size();
+        }
+        record = data.substr(pos, end - pos);
+        pos = end + 1;
+        return true;
+    }
+
+private:
+    std::string_view data;
+    size_t pos = 0;
+};
+
+// Разбор JSON без копирования: все токены хранятся в одном массиве и ссылаются на исходный буфер.
+// Буфер должен существовать, пока используется документ
+class JsonDocument {
+public:
+    enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+
+    struct Token {
+        Type type;
+        bool hasEscapes;       // Строка содержит escape-последовательности
+        uint32_t count;        // Количество элементов массива или полей объекта
+        uint32_t next;         // Индекс токена, следующего за этим значением целиком
+        std::string_view raw;  // Для строк - содержимое между кавычками
+    };
+
+    // Ссылка на значение внутри документа; отсутствующее значение ведет себя как null
+    class Value {
+    public:
+        Value() = default;
+        Value(const JsonDocument* doc, uint32_t index) : doc(doc), index(index) {}
+
+        bool exists() const { return doc != nullptr; }
+        Type type() const { return exists() ? token().type : Type::Null; }
+        bool isNull() const { return type() == Type::Null; }
+        bool isString() const { return type() == Type::String; }
+        bool isArray() const { return type() == Type::Array; }
+        bool isObject() const { return type() == Type::Object; }
+        size_t size() const { return (isArray() || isObject()) ? token().count : 0; }
+
+        // Исходный фрагмент текста (для строк - без кавычек и без раскодирования)
+        std::string_view raw() const { return exists() ? token().raw : std::string_view(); }
+
+        // Строковое значение; память выделяется только здесь, по запросу
+        std::string asString() const {
+            if (!isString()) {
+                return exists() && type() != Type::Null ? std::string(raw()) : std::string();
+            }
+            return token().hasEscapes ? unescape(raw()) : std::string(raw());
+        }
+
+        long long asInt(long long fallback = 0) const {
+            if (type() != Type::Number) {
+                return fallback;
+            }
+            long long value = fallback;
+            std::string_view text = raw();
+            size_t dot = text.find_first_of(".eE");
+            std::from_chars(text.data(), text.data() + (dot == std::string_view::npos ? text.size() : dot), value);
+            return value;
+        }
+
+        bool asBool(bool fallback = false) const {
+            return type() == Type::Bool ? raw() == "true" : fallback;
+        }
+
+        // Поле объекта по имени
+        Value operator[](std::string_view key) const {
+            if (!isObject()) {
+                return Value();
+            }
+            uint32_t i = index + 1;
+            for (uint32_t member = 0; member < token().count; member++) {
+                if (doc->tokens[i].raw == key) {
+                    return Value(doc, i + 1);
+                }
+                i = doc->tokens[i + 1].next;
+            }
+            return Value();
+        }
+
+        // Элемент массива по номеру
+        Value at(size_t position) const {
+            if (!isArray() || position >= token().count) {
+                return Value();
+            }
+            uint32_t i = index + 1;
+            for (size_t element = 0; element < position; element++) {
+                i = doc->tokens[i].next;
+            }
+            return Value(doc, i);
+        }
+
+        // Обход элементов массива
+        void forEach(const std::function<void(const Value&)>& callback) const {
+            if (!isArray()) {
+                return;
+            }
+            uint32_t i = index + 1;
+            for (uint32_t element = 0; element < token().count; element++) {
+                callback(Value(doc, i));
+                i = doc->tokens[i].next;
+            }
+        }
+
+        // Обход полей объекта
+        void forEachMember(const std::function<void(std::string_view, const Value&)>& callback) const {
+            if (!isObject()) {
+                return;
+            }
+            uint32_t i = index + 1;
+            for (uint32_t member = 0; member < token().count; member++) {
+                callback(doc->tokens[i].raw, Value(doc, i + 1));
+                i = doc->tokens[i + 1].next;
+            }
+        }
+
+    private:
+        const JsonDocument* doc = nullptr;
+        uint32_t index = 0;
+
+        const Token& token() const { return doc->tokens[index]; }
+    };
+
+    explicit JsonDocument(std::string_view text) : text(text) {
+        size_t pos = 0;
+        valid = parseValue(pos, 0);
+        skipWhitespace(pos);
+        valid = valid && pos == text.size();
+    }
+
+    bool isValid() const { return valid; }
+    Value root() const { return valid && !tokens.empty() ? Value(this, 0) : Value(); }
+
+    // Раскодирование escape-последовательностей JSON в UTF-8
+    static std::string unescape(std::string_view raw) {
         std::string result;
-        char buffer[128];
-        FILE* pipe = _popen(command.c_str(), "r");
-        
-        if (!pipe) {
-            return "Ошибка выполнения команды.";
+        result.reserve(raw.size());
+
+        for (size_t i = 0; i < raw.size(); i++) {
+            if (raw[i] != '\\' || i + 1 >= raw.size()) {
+                result.push_back(raw[i]);
+                continue;
+            }
+
+            char escaped = raw[++i];
+            switch (escaped) {
+                case 'b': result.push_back('\b'); break;
+                case 'f': result.push_back('\f'); break;
+                case 'n': result.push_back('\n'); break;
+                case 'r': result.push_back('\r'); break;
+                case 't': result.push_back('\t'); break;
+                case 'u': {
+                    uint32_t code = parseHex4(raw, i + 1);
+                    i += 4;
+                    // Суррогатная пара UTF-16
+                    if (code >= 0xD800 && code <= 0xDBFF && i + 6 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+                        uint32_t low = parseHex4(raw, i + 3);
+                        if (low >= 0xDC00 && low <= 0xDFFF) {
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                            i += 6;
+                        }
+                    }
+                    appendUtf8(result, code);
+                    break;
+                }
+                default: result.push_back(escaped); break; // \" \\ \/
+            }
+        }
+        return result;
+    }
+
+    // Экранирование строки для вставки в JSON
+    static std::string escape(std::string_view value) {
+        std::string result;
+        result.reserve(value.size() + 2);
+        for (char c : value) {
+            switch (c) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+                        result += buffer;
+                    } else {
+                        result.push_back(c);
+                    }
+            }
+        }
+        return result;
+    }
+
+private:
+    std::string_view text;
+    std::vector<Token> tokens;
+    bool valid = false;
+
+    static const int maxDepth = 256;
+
+    void skipWhitespace(size_t& pos) const {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            pos++;
+        }
+    }
+
+    uint32_t addToken(Type type, std::string_view raw) {
+        tokens.push_back({type, false, 0, 0, raw});
+        return static_cast<uint32_t>(tokens.size() - 1);
+    }
+
+    bool parseString(size_t& pos) {
+        size_t start = ++pos; // Пропускаем открывающую кавычку
+        bool hasEscapes = false;
+        while (pos < text.size() && text[pos] != '"') {
+            if (text[pos] == '\\') {
+                hasEscapes = true;
+                pos++;
+            }
+            pos++;
+        }
+        if (pos >= text.size()) {
+            return false;
+        }
+        uint32_t index = addToken(Type::String, text.substr(start, pos - start));
+        tokens[index].hasEscapes = hasEscapes;
+        tokens[index].next = index + 1;
+        pos++; // Закрывающая кавычка
+        return true;
+    }
+
+    bool parseValue(size_t& pos, int depth) {
+        if (depth > maxDepth) {
+            return false;
+        }
+        skipWhitespace(pos);
+        if (pos >= text.size()) {
+            return false;
+        }
+
+        char c = text[pos];
+        if (c == '"') {
+            return parseString(pos);
+        }
+
+        if (c == '{' || c == '[') {
+            bool isObject = (c == '{');
+            char close = isObject ? '}' : ']';
+            uint32_t index = addToken(isObject ? Type::Object : Type::Array, text.substr(pos, 1));
+            size_t start = pos++;
+            uint32_t count = 0;
+
+            skipWhitespace(pos);
+            if (pos < text.size() && text[pos] == close) {
+                pos++;
+            } else {
+                while (true) {
+                    if (isObject) {
+                        skipWhitespace(pos);
+                        if (pos >= text.size() || text[pos] != '"' || !parseString(pos)) {
+                            return false;
+                        }
+                        skipWhitespace(pos);
+                        if (pos >= text.size() || text[pos] != ':') {
+                            return false;
+                        }
+                        pos++;
+                    }
+                    if (!parseValue(pos, depth + 1)) {
+                        return false;
+                    }
+                    count++;
+
+                    skipWhitespace(pos);
+                    if (pos < text.size() && text[pos] == ',') {
+                        pos++;
+                    } else if (pos < text.size() && text[pos] == close) {
+                        pos++;
+                        break;
+                    } else {
+                        return false;
+                    }
+                }
+            }
+
+            tokens[index].count = count;
+            tokens[index].next = static_cast<uint32_t>(tokens.size());
+            tokens[index].raw = text.substr(start, pos - start);
+            return true;
+        }
+
+        // Число, true, false или null
+        size_t start = pos;
+        while (pos < text.size() && std::string_view(",}] \t\r\n").find(text[pos]) == std::string_view::npos) {
+            pos++;
+        }
+        std::string_view literal = text.substr(start, pos - start);
+
+        Type type;
+        if (literal == "true" || literal == "false") {
+            type = Type::Bool;
+        } else if (literal == "null") {
+            type = Type::Null;
+        } else if (!literal.empty() && (literal[0] == '-' || (literal[0] >= '0' && literal[0] <= '9'))) {
+            type = Type::Number;
+        } else {
+            return false;
+        }
+
+        uint32_t index = addToken(type, literal);
+        tokens[index].next = index + 1;
+        return true;
+    }
+
+    static uint32_t parseHex4(std::string_view raw, size_t pos) {
+        uint32_t value = 0;
+        for (size_t i = pos; i < pos + 4 && i < raw.size(); i++) {
+            char c = raw[i];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+        }
+        return value;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+};
+
+// HTTP-запрос к API (путь указывается относительно базового адреса)
+struct HttpRequest {
+    std::string method = "GET";
+    std::string path;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+};
+
+// HTTP-ответ; имена заголовков хранятся в нижнем регистре
+struct HttpResponse {
+    int status = 0;              // 0 - запрос не был выполнен (см. error)
+    std::map<std::string, std::string> headers;
+    std::string body;
+    std::string error;
+    double latencyMs = 0;
+
+    bool ok() const {
+        return status >= 200 && status < 300;
+    }
+
+    std::string header(const std::string& name) const {
+        auto it = headers.find(name);
+        return it != headers.end() ? it->second : "";
+    }
+};
+
+// Сетевой уровень клиента API. Заменяемая реализация позволяет направить запросы,
+// например, на локальный тестовый HTTP-сервер
+class HttpTransport {
+public:
+    virtual ~HttpTransport() = default;
+    virtual HttpResponse send(const std::string& baseUrl, const HttpRequest& request) = 0;
+};
+
+// Транспорт на WinHTTP. Одна сессия на весь процесс: WinHTTP держит пул keep-alive соединений,
+// поэтому TLS-рукопожатие выполняется только для первого запроса к узлу
+class WinHttpTransport : public HttpTransport {
+public:
+    WinHttpTransport() {
+        session = WinHttpOpen(L"github-manager/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+                              WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+        if (session != nullptr) {
+            // Разрешение имени, соединение, отправка, получение (мс)
+            WinHttpSetTimeouts(session, 10000, 10000, 30000, 60000);
+        }
+    }
+
+    ~WinHttpTransport() override {
+        for (auto& connection : connections) {
+            WinHttpCloseHandle(connection.second);
+        }
+        if (session != nullptr) {
+            WinHttpCloseHandle(session);
+        }
+    }
+
+    WinHttpTransport(const WinHttpTransport&) = delete;
+    WinHttpTransport& operator=(const WinHttpTransport&) = delete;
+
+    HttpResponse send(const std::string& baseUrl, const HttpRequest& request) override {
+        HttpResponse response;
+        auto started = std::chrono::steady_clock::now();
+
+        bool secure = false;
+        std::string host, basePath;
+        INTERNET_PORT port = 0;
+        if (!parseUrl(baseUrl, secure, host, port, basePath)) {
+            response.error = "Некорректный адрес API: " + baseUrl;
+            return response;
+        }
+
+        HINTERNET connection = getConnection(host, port);
+        if (connection == nullptr) {
+            response.error = "WinHTTP: не удалось подключиться (" + std::to_string(GetLastError()) + ")";
+            return response;
+        }
+
+        std::wstring method = toWide(request.method);
+        std::wstring path = toWide(basePath + request.path);
+        HINTERNET handle = WinHttpOpenRequest(connection, method.c_str(), path.c_str(), nullptr,
+                                              WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                              secure ? WINHTTP_FLAG_SECURE : 0);
+        if (handle == nullptr) {
+            response.error = "WinHTTP: не удалось создать запрос (" + std::to_string(GetLastError()) + ")";
+            return response;
+        }
+
+        std::wstring headers;
+        for (const auto& header : request.headers) {
+            headers += toWide(header.first + ": " + header.second + "\r\n");
+        }
+
+        DWORD bodySize = static_cast<DWORD>(request.body.size());
+        BOOL sent = WinHttpSendRequest(handle,
+                                       headers.empty() ? WINHTTP_NO_ADDITIONAL_HEADERS : headers.c_str(),
+                                       headers.empty() ? 0 : static_cast<DWORD>(-1L),
+                                       bodySize > 0 ? const_cast<char*>(request.body.data()) : WINHTTP_NO_REQUEST_DATA,
+                                       bodySize, bodySize, 0);
+
+        if (!sent || !WinHttpReceiveResponse(handle, nullptr)) {
+            response.error = "WinHTTP: ошибка обмена данными (" + std::to_string(GetLastError()) + ")";
+            WinHttpCloseHandle(handle);
+            return response;
+        }
+
+        DWORD statusCode = 0;
+        DWORD size = sizeof(statusCode);
+        WinHttpQueryHeaders(handle, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                            WINHTTP_HEADER_NAME_BY_INDEX, &statusCode, &size, WINHTTP_NO_HEADER_INDEX);
+        response.status = static_cast<int>(statusCode);
+        readHeaders(handle, response);
+
+        // Тело читается полностью: только тогда соединение возвращается в пул
+        DWORD available = 0;
+        while (WinHttpQueryDataAvailable(handle, &available) && available > 0) {
+            size_t offset = response.body.size();
+            response.body.resize(offset + available);
+            DWORD read = 0;
+            if (!WinHttpReadData(handle, &response.body[offset], available, &read)) {
+                response.body.resize(offset);
+                break;
+            }
+            response.body.resize(offset + read);
+        }
+
+        WinHttpCloseHandle(handle);
+        response.latencyMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - started).count();
+        return response;
+    }
+
+private:
+    HINTERNET session = nullptr;
+    std::map<std::string, HINTERNET> connections;
+    std::mutex connectionsMutex;
+
+    static std::wstring toWide(const std::string& str) {
+        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+        return converter.from_bytes(str);
+    }
+
+    static std::string toNarrow(const std::wstring& wstr) {
+        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+        return converter.to_bytes(wstr);
+    }
+
+    // Разбор адреса вида "https://host[:port][/path]"
+    static bool parseUrl(const std::string& url, bool& secure, std::string& host, INTERNET_PORT& port, std::string& basePath) {
+        size_t schemeEnd = url.find("://");
+        if (schemeEnd == std::string::npos) {
+            return false;
+        }
+        std::string scheme = url.substr(0, schemeEnd);
+        secure = (scheme == "https");
+        if (!secure && scheme != "http") {
+            return false;
         }
 
-        while (!feof(pipe)) {
-            if (fgets(buffer, 128, pipe) != nullptr) {
-                result += buffer;
+        size_t hostStart = schemeEnd + 3;
+        size_t pathStart = url.find('/', hostStart);
+        std::string authority = url.substr(hostStart, pathStart == std::string::npos ? std::string::npos : pathStart - hostStart);
+        basePath = pathStart == std::string::npos ? "" : url.substr(pathStart);
+        if (!basePath.empty() && basePath.back() == '/') {
+            basePath.pop_back();
+        }
+
+        size_t colon = authority.rfind(':');
+        if (colon != std::string::npos) {
+            host = authority.substr(0, colon);
+            try {
+                port = static_cast<INTERNET_PORT>(std::stoi(authority.substr(colon + 1)));
+            } catch (const std::exception&) {
+                return false;
+            }
+        } else {
+            host = authority;
+            port = secure ? INTERNET_DEFAULT_HTTPS_PORT : INTERNET_DEFAULT_HTTP_PORT;
+        }
+        return !host.empty();
+    }
+
+    HINTERNET getConnection(const std::string& host, INTERNET_PORT port) {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        std::string key = host + ":" + std::to_string(port);
+        auto it = connections.find(key);
+        if (it != connections.end()) {
+            return it->second;
+        }
+        if (session == nullptr) {
+            return nullptr;
+        }
+        HINTERNET connection = WinHttpConnect(session, toWide(host).c_str(), port, 0);
+        if (connection != nullptr) {
+            connections[key] = connection;
+        }
+        return connection;
+    }
+
+    static void readHeaders(HINTERNET handle, HttpResponse& response) {
+        DWORD size = 0;
+        WinHttpQueryHeaders(handle, WINHTTP_QUERY_RAW_HEADERS_CRLF, WINHTTP_HEADER_NAME_BY_INDEX,
+                            WINHTTP_NO_OUTPUT_BUFFER, &size, WINHTTP_NO_HEADER_INDEX);
+        if (size == 0) {
+            return;
+        }
+
+        std::wstring raw(size / sizeof(wchar_t), L'\0');
+        if (!WinHttpQueryHeaders(handle, WINHTTP_QUERY_RAW_HEADERS_CRLF, WINHTTP_HEADER_NAME_BY_INDEX,
+                                 &raw[0], &size, WINHTTP_NO_HEADER_INDEX)) {
+            return;
+        }
+
+        std::istringstream stream(toNarrow(raw.c_str()));
+        std::string line;
+        while (std::getline(stream, line)) {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue; // Строка статуса
+            }
+            std::string name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            size_t valueStart = line.find_first_not_of(' ', colon + 1);
+            size_t valueEnd = line.find_last_not_of("\r ");
+            response.headers[name] = (valueStart == std::string::npos || valueEnd < valueStart) ?
+                                     "" : line.substr(valueStart, valueEnd - valueStart + 1);
+        }
+    }
+};
+
+// Параметры планировщика запросов к API
+struct RateLimitPolicy {
+    int maxConcurrent = 6;              // Одновременно выполняемых запросов
+    double requestsPerSecond = 10;      // Скорость пополнения корзины запросов
+    int burst = 10;                     // Емкость корзины
+    double writesPerSecond = 1;         // Изменяющие запросы: GitHub рекомендует не чаще раза в секунду
+    int maxRetries = 5;
+    std::chrono::milliseconds baseBackoff{1000};       // Первая пауза после ошибки сервера или сети
+    std::chrono::milliseconds maxBackoff{60000};
+    std::chrono::milliseconds secondaryBackoff{60000}; // Вторичный лимит без Retry-After
+    std::chrono::milliseconds maxWait{300000};         // Более долгое ожидание - вернуть ошибку сразу
+};
+
+// Корзина токенов с резервированием: токен можно занять в долг, тогда возвращается
+// момент, когда он станет доступен. Вызывается под блокировкой владельца
+class TokenBucket {
+public:
+    void configure(double rate, int capacity) {
+        ratePerSecond = std::max(0.01, rate);
+        this->capacity = std::max(1, capacity);
+        tokens = std::min(tokens, static_cast<double>(this->capacity));
+    }
+
+    std::chrono::steady_clock::time_point reserve(std::chrono::steady_clock::time_point now) {
+        if (!initialized) {
+            tokens = capacity;
+            updatedAt = now;
+            initialized = true;
+        }
+        double elapsed = std::chrono::duration<double>(now - updatedAt).count();
+        tokens = std::min(static_cast<double>(capacity), tokens + elapsed * ratePerSecond);
+        updatedAt = now;
+
+        tokens -= 1;
+        if (tokens >= 0) {
+            return now;
+        }
+        return now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(-tokens / ratePerSecond));
+    }
+
+private:
+    double ratePerSecond = 1;
+    int capacity = 1;
+    double tokens = 0;
+    bool initialized = false;
+    std::chrono::steady_clock::time_point updatedAt;
+};
+
+// Планировщик всех исходящих запросов к API: ограничивает число одновременных запросов
+// и их частоту, учитывает X-RateLimit-* и Retry-After и повторяет запросы с паузой и разбросом.
+// Пауза после исчерпания лимита действует для всех потоков сразу
+class RateLimitScheduler {
+public:
+    using WaitCallback = std::function<void(std::chrono::milliseconds, const std::string&)>;
+
+    RateLimitScheduler() : random(std::random_device{}()) {
+        configure(RateLimitPolicy());
+    }
+
+    void configure(const RateLimitPolicy& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        policy = value;
+        policy.maxConcurrent = std::max(1, policy.maxConcurrent);
+        requests.configure(policy.requestsPerSecond, policy.burst);
+        writes.configure(policy.writesPerSecond, 1);
+        slotAvailable.notify_all();
+    }
+
+    // Обработчик вызывается перед каждым повтором с длительностью паузы и причиной
+    void setWaitCallback(WaitCallback callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+        onWait = std::move(callback);
+    }
+
+    HttpResponse execute(const std::string& method, const std::function<HttpResponse()>& send) {
+        bool write = method != "GET" && method != "HEAD";
+        for (int attempt = 0;; ++attempt) {
+            acquire(write);
+            HttpResponse response = send();
+
+            Decision decision = release(response, write, attempt);
+            if (!decision.retry) {
+                return response;
+            }
+            if (decision.callback) {
+                decision.callback(decision.delay, decision.reason);
+            }
+            if (!decision.global) {
+                std::this_thread::sleep_for(decision.delay);
+            }
+        }
+    }
+
+private:
+    void acquire(bool write) {
+        std::unique_lock<std::mutex> lock(mutex);
+        slotAvailable.wait(lock, [this] { return active < policy.maxConcurrent; });
+        ++active;
+
+        auto now = std::chrono::steady_clock::now();
+        auto readyAt = requests.reserve(now);
+        if (write) {
+            readyAt = std::max(readyAt, writes.reserve(now));
+        }
+        // Пауза может продлиться, пока поток ждет (ответ другого потока с исчерпанным лимитом)
+        while (std::max(readyAt, pausedUntil) > std::chrono::steady_clock::now()) {
+            auto until = std::max(readyAt, pausedUntil);
+            lock.unlock();
+            std::this_thread::sleep_until(until);
+            lock.lock();
+        }
+    }
+
+    struct Decision {
+        bool retry = false;
+        bool global = false;    // Ограничение касается всех запросов, а не только этого
+        std::chrono::milliseconds delay{0};
+        std::string reason;
+        WaitCallback callback;
+    };
+
+    Decision release(const HttpResponse& response, bool write, int attempt) {
+        std::lock_guard<std::mutex> lock(mutex);
+        --active;
+        auto now = std::chrono::steady_clock::now();
+
+        Decision decision;
+        decision.delay = retryDelay(response, write, attempt, decision.reason, decision.global);
+        decision.retry = !decision.reason.empty() && attempt < policy.maxRetries && decision.delay <= policy.maxWait;
+        decision.callback = onWait;
+        if (decision.retry && decision.global) {
+            pausedUntil = std::max(pausedUntil, now + decision.delay);
+        }
+
+        // Лимит исчерпан последним успешным запросом - следующие ждут его восстановления
+        if (response.header("x-ratelimit-remaining") == "0") {
+            auto resetIn = secondsUntilReset(response);
+            if (resetIn.count() > 0 && resetIn <= policy.maxWait) {
+                pausedUntil = std::max(pausedUntil, now + resetIn);
+            }
+        }
+        slotAvailable.notify_one();
+        return decision;
+    }
+
+    // Пауза перед повтором; пустая причина - ответ окончательный
+    std::chrono::milliseconds retryDelay(const HttpResponse& response, bool write, int attempt,
+                                         std::string& reason, bool& global) {
+        std::string retryAfter = response.header("retry-after");
+        bool exhausted = response.header("x-ratelimit-remaining") == "0";
+        bool rateLimited = response.status == 429 ||
+                           (response.status == 403 && (exhausted || !retryAfter.empty() ||
+                                                       response.body.find("secondary rate limit") != std::string::npos));
+        if (rateLimited) {
+            reason = "rate limit";
+            global = true;
+            if (!retryAfter.empty() && std::isdigit(static_cast<unsigned char>(retryAfter[0]))) {
+                return std::chrono::seconds(std::stoll(retryAfter)) + jitter(std::chrono::milliseconds(250));
+            }
+            if (exhausted && secondsUntilReset(response).count() > 0) {
+                return secondsUntilReset(response) + jitter(std::chrono::milliseconds(250));
+            }
+            return backoff(policy.secondaryBackoff, attempt);
+        }
+
+        // Ошибки сети и шлюза повторяются только для чтения: изменение могло быть уже применено
+        bool transient = response.status == 0 || response.status == 502 ||
+                         response.status == 503 || response.status == 504;
+        if (transient && !write) {
+            reason = response.status == 0 ? "network error" : "HTTP " + std::to_string(response.status);
+            return backoff(policy.baseBackoff, attempt);
+        }
+        return std::chrono::milliseconds(0);
+    }
+
+    static std::chrono::milliseconds secondsUntilReset(const HttpResponse& response) {
+        std::string reset = response.header("x-ratelimit-reset");
+        if (reset.empty() || !std::isdigit(static_cast<unsigned char>(reset[0]))) {
+            return std::chrono::milliseconds(0);
+        }
+        long long seconds = std::stoll(reset) - static_cast<long long>(std::time(nullptr));
+        return std::chrono::seconds(std::max(0LL, seconds) + 1);
+    }
+
+    // Экспоненциальная пауза с разбросом в пределах [d/2, d]: повторы потоков не совпадают во времени
+    std::chrono::milliseconds backoff(std::chrono::milliseconds base, int attempt) {
+        long long limit = std::max(policy.maxBackoff.count(), base.count());
+        long long delay = std::min<long long>(limit, base.count() << std::min(attempt, 16));
+        return std::chrono::milliseconds(delay / 2) + jitter(std::chrono::milliseconds(delay - delay / 2));
+    }
+
+    std::chrono::milliseconds jitter(std::chrono::milliseconds range) {
+        if (range.count() <= 0) {
+            return range;
+        }
+        std::uniform_int_distribution<long long> distribution(0, range.count());
+        return std::chrono::milliseconds(distribution(random));
+    }
+
+    std::mutex mutex;
+    std::condition_variable slotAvailable;
+    RateLimitPolicy policy;
+    TokenBucket requests;
+    TokenBucket writes;
+    int active = 0;
+    std::chrono::steady_clock::time_point pausedUntil;
+    std::mt19937 random;
+    WaitCallback onWait;
+};
+
+// Клиент GitHub REST API: добавляет стандартные заголовки и токен авторизации
+class GitHubApiClient {
+public:
+    GitHubApiClient(std::unique_ptr<HttpTransport> transport, std::string baseUrl)
+        : transport(std::move(transport)), baseUrl(std::move(baseUrl)) {}
+
+    void setToken(const std::string& value) {
+        token = value;
+    }
+
+    bool hasToken() const {
+        return !token.empty();
+    }
+
+    const std::string& getBaseUrl() const {
+        return baseUrl;
+    }
+
+    const std::string& getToken() const {
+        return token;
+    }
+
+    HttpResponse request(const std::string& method, const std::string& path, const std::string& body = "",
+                         const std::vector<std::pair<std::string, std::string>>& extraHeaders = {}) {
+        HttpRequest httpRequest;
+        httpRequest.method = method;
+        httpRequest.path = path;
+        httpRequest.body = body;
+        httpRequest.headers = {
+            {"Accept", "application/vnd.github+json"},
+            {"X-GitHub-Api-Version", "2022-11-28"},
+            {"User-Agent", "github-manager"},
+        };
+        if (!token.empty()) {
+            httpRequest.headers.push_back({"Authorization", "Bearer " + token});
+        }
+        if (!body.empty()) {
+            httpRequest.headers.push_back({"Content-Type", "application/json"});
+        }
+        for (const auto& header : extraHeaders) {
+            httpRequest.headers.push_back(header);
+        }
+        return scheduler.execute(method, [this, &httpRequest] {
+            return transport->send(baseUrl, httpRequest);
+        });
+    }
+
+    RateLimitScheduler& getScheduler() {
+        return scheduler;
+    }
+
+    HttpResponse get(const std::string& path) {
+        return request("GET", path);
+    }
+
+    HttpResponse post(const std::string& path, const std::string& body) {
+        return request("POST", path, body);
+    }
+
+    HttpResponse del(const std::string& path) {
+        return request("DELETE", path);
+    }
+
+private:
+    std::unique_ptr<HttpTransport> transport;
+    RateLimitScheduler scheduler;
+    std::string baseUrl;
+    std::string token;
+};
+
+// Пакет независимых запросов на чтение, отправляемый одним GraphQL-запросом.
+// Каждая выборка получает свой псевдоним, результат передается обработчику вызывающей стороны
+class GraphQLBatch {
+public:
+    using Handler = std::function<void(const JsonDocument::Value&)>;
+
+    // selection - поле верхнего уровня Query, например "viewer { login }"
+    void add(const std::string& selection, Handler handler) {
+        entries.push_back({selection, std::move(handler)});
+    }
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    std::string buildQuery() const {
+        std::string query = "query {";
+        for (size_t i = 0; i < entries.size(); i++) {
+            query += " q" + std::to_string(i) + ": " + entries[i].selection;
+        }
+        query += " }";
+        return query;
+    }
+
+    // Выполняет пакет. Обработчик вызывается для каждой выборки, вернувшей данные;
+    // первая ошибка GraphQL (если есть) записывается в error ответа
+    HttpResponse execute(GitHubApiClient& client) const {
+        HttpResponse response = client.post("/graphql", "{\"query\":\"" + JsonDocument::escape(buildQuery()) + "\"}");
+        if (!response.ok()) {
+            return response;
+        }
+
+        JsonDocument document(response.body);
+        if (!document.isValid()) {
+            response.error = "Некорректный ответ GraphQL";
+            return response;
+        }
+
+        JsonDocument::Value errors = document.root()["errors"];
+        if (errors.isArray() && errors.size() > 0) {
+            response.error = errors.at(0)["message"].asString();
+        }
+
+        JsonDocument::Value data = document.root()["data"];
+        for (size_t i = 0; i < entries.size(); i++) {
+            JsonDocument::Value value = data["q" + std::to_string(i)];
+            if (value.exists() && !value.isNull()) {
+                entries[i].handler(value);
+            }
+        }
+        return response;
+    }
+
+    // Строковый литерал GraphQL (правила экранирования совпадают с JSON)
+    static std::string quote(const std::string& value) {
+        return "\"" + JsonDocument::escape(value) + "\"";
+    }
+
+private:
+    struct Entry {
+        std::string selection;
+        Handler handler;
+    };
+    std::vector<Entry> entries;
+};
+
+// Дисковый кэш постраничного ответа API: тело и ETag каждой страницы.
+// Формат: заголовок "github-manager-pages 1 <время сохранения> <число страниц>",
+// затем для каждой страницы строка "<номер> <длина ETag> <длина тела>" и сами данные
+class PageCache {
+public:
+    struct Page {
+        std::string etag;
+        std::string body;
+    };
+
+    bool load(const std::filesystem::path& file) {
+        pages.clear();
+        std::ifstream in(file, std::ios::binary);
+        std::string magic;
+        int version = 0;
+        if (!(in >> magic >> version >> savedAt >> lastPage) || magic != "github-manager-pages" || version != 1) {
+            savedAt = 0;
+            lastPage = 0;
+            return false;
+        }
+
+        int number = 0;
+        size_t etagLength = 0, bodyLength = 0;
+        while (in >> number >> etagLength >> bodyLength) {
+            in.get(); // Перевод строки после заголовка страницы
+            Page page;
+            page.etag.resize(etagLength);
+            page.body.resize(bodyLength);
+            if (!in.read(&page.etag[0], etagLength) || !in.read(&page.body[0], bodyLength)) {
+                break;
+            }
+            pages[number] = std::move(page);
+        }
+        return true;
+    }
+
+    bool save(const std::filesystem::path& file) const {
+        std::error_code ec;
+        std::filesystem::create_directories(file.parent_path(), ec);
+        std::filesystem::path temp = file;
+        temp += ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out << "github-manager-pages 1 " << savedAt << " " << lastPage << "\n";
+            for (const auto& page : pages) {
+                out << page.first << " " << page.second.etag.size() << " " << page.second.body.size() << "\n"
+                    << page.second.etag << page.second.body;
+            }
+            if (!out) {
+                return false;
+            }
+        }
+        std::filesystem::rename(temp, file, ec);
+        return !ec;
+    }
+
+    const Page* find(int number) const {
+        auto it = pages.find(number);
+        return it != pages.end() ? &it->second : nullptr;
+    }
+
+    void put(int number, std::string etag, std::string body) {
+        pages[number] = {std::move(etag), std::move(body)};
+    }
+
+    // Удаляет страницы после последней
+    void truncate(int last) {
+        pages.erase(pages.upper_bound(last), pages.end());
+        lastPage = last;
+    }
+
+    bool isComplete() const {
+        for (int i = 1; i <= lastPage; i++) {
+            if (pages.find(i) == pages.end()) {
+                return false;
+            }
+        }
+        return lastPage > 0;
+    }
+
+    long long savedAt = 0;
+    int lastPage = 0;
+
+private:
+    std::map<int, Page> pages;
+};
+
+// Файл, отображенный в память только для чтения
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            close();
+            return false;
+        }
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (view == nullptr) {
+            close();
+            return false;
+        }
+        length = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    void close() {
+        if (view != nullptr) {
+            UnmapViewOfFile(view);
+        }
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        view = nullptr;
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+        length = 0;
+    }
+
+    const char* data() const {
+        return static_cast<const char*>(view);
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+private:
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+    LPVOID view = nullptr;
+    size_t length = 0;
+};
+
+// Репозиторий в локальном индексе
+struct RepositoryRecord {
+    std::string fullName;
+    std::string description;
+    std::string topics;      // Через пробел
+    std::string language;
+    long long pushedAt = 0;  // Время последней отправки (unix)
+    bool isPrivate = false;
+};
+
+// Локальный индекс доступных репозиториев. Файл читается через отображение в память:
+// заголовок, записи (отсортированы по полному имени), таблица триграмм и пул строк.
+// Поиск по подстроке длиной от 3 символов использует пересечение списков триграмм
+class RepositoryIndex {
+public:
+    bool open(const std::filesystem::path& path) {
+        close();
+        if (!file.open(path.string()) || file.size() < sizeof(Header)) {
+            file.close();
+            return false;
+        }
+
+        header = reinterpret_cast<const Header*>(file.data());
+        size_t expected = sizeof(Header) + header->count * sizeof(Entry) +
+                          header->trigramCount * sizeof(Trigram) + header->poolSize;
+        if (std::memcmp(header->magic, "GHRI", 4) != 0 || header->version != 1 || file.size() != expected) {
+            close();
+            return false;
+        }
+
+        entries = reinterpret_cast<const Entry*>(file.data() + sizeof(Header));
+        trigrams = reinterpret_cast<const Trigram*>(entries + header->count);
+        pool = reinterpret_cast<const char*>(trigrams + header->trigramCount);
+        return true;
+    }
+
+    void close() {
+        file.close();
+        header = nullptr;
+        entries = nullptr;
+        trigrams = nullptr;
+        pool = nullptr;
+    }
+
+    bool isOpen() const {
+        return header != nullptr;
+    }
+
+    size_t size() const {
+        return header != nullptr ? header->count : 0;
+    }
+
+    long long newestPush() const {
+        return header != nullptr ? header->newestPush : 0;
+    }
+
+    long long fullBuildAt() const {
+        return header != nullptr ? header->fullBuildAt : 0;
+    }
+
+    std::string_view fullName(uint32_t index) const {
+        return std::string_view(pool + entries[index].offset, entries[index].nameLength);
+    }
+
+    RepositoryRecord record(uint32_t index) const {
+        const Entry& entry = entries[index];
+        const char* text = pool + entry.offset;
+        RepositoryRecord record;
+        record.fullName.assign(text, entry.nameLength);
+        text += entry.nameLength;
+        record.description.assign(text, entry.descriptionLength);
+        text += entry.descriptionLength;
+        record.topics.assign(text, entry.topicsLength);
+        text += entry.topicsLength;
+        record.language.assign(text, entry.languageLength);
+        record.pushedAt = entry.pushedAt;
+        record.isPrivate = (entry.flags & FlagPrivate) != 0;
+        return record;
+    }
+
+    std::vector<RepositoryRecord> records() const {
+        std::vector<RepositoryRecord> result;
+        result.reserve(size());
+        for (uint32_t i = 0; i < size(); i++) {
+            result.push_back(record(i));
+        }
+        return result;
+    }
+
+    // Точный поиск по полному имени (без учета регистра) двоичным поиском
+    int find(const std::string& fullNameQuery) const {
+        std::string key = toLower(fullNameQuery);
+        uint32_t low = 0, high = static_cast<uint32_t>(size());
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            if (searchText(mid).substr(0, entries[mid].nameLength) < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low < size() && searchText(low).substr(0, entries[low].nameLength) == key) {
+            return static_cast<int>(low);
+        }
+        return -1;
+    }
+
+    // Поиск по имени, описанию и темам. Порядок: точное имя, начало имени, начало полного
+    // имени, вхождение в имя, вхождение в описание или темы; при равенстве - недавно обновленные
+    std::vector<uint32_t> search(const std::string& query, size_t limit) const {
+        std::string needle = toLower(query);
+        std::vector<uint32_t> candidates;
+        if (needle.size() >= 3) {
+            candidates = trigramCandidates(needle);
+        } else {
+            candidates.resize(size());
+            for (uint32_t i = 0; i < size(); i++) {
+                candidates[i] = i;
+            }
+        }
+
+        std::vector<std::pair<int, uint32_t>> ranked;
+        for (uint32_t index : candidates) {
+            std::string_view text = searchText(index);
+            size_t position = text.find(needle);
+            if (position == std::string_view::npos) {
+                continue;
+            }
+
+            std::string_view name = text.substr(0, entries[index].nameLength);
+            std::string_view shortName = name.substr(name.find('/') + 1);
+            int rank;
+            if (shortName == needle || name == needle) {
+                rank = 0;
+            } else if (shortName.compare(0, needle.size(), needle) == 0) {
+                rank = 1;
+            } else if (position == 0) {
+                rank = 2;
+            } else if (position < name.size()) {
+                rank = 3;
+            } else {
+                rank = 4;
+            }
+            ranked.push_back({rank, index});
+        }
+
+        std::sort(ranked.begin(), ranked.end(), [this](const auto& a, const auto& b) {
+            if (a.first != b.first) {
+                return a.first < b.first;
+            }
+            return entries[a.second].pushedAt > entries[b.second].pushedAt;
+        });
+
+        std::vector<uint32_t> result;
+        for (size_t i = 0; i < ranked.size() && i < limit; i++) {
+            result.push_back(ranked[i].second);
+        }
+        return result;
+    }
+
+    // Запись индекса во временный файл с последующей заменой (перед заменой индекс нужно закрыть)
+    static bool write(const std::filesystem::path& path, std::vector<RepositoryRecord> records, long long fullBuildAt) {
+        std::sort(records.begin(), records.end(), [](const RepositoryRecord& a, const RepositoryRecord& b) {
+            return toLower(a.fullName) < toLower(b.fullName);
+        });
+
+        Header header{};
+        std::memcpy(header.magic, "GHRI", 4);
+        header.version = 1;
+        header.count = static_cast<uint32_t>(records.size());
+        header.fullBuildAt = fullBuildAt;
+
+        std::vector<Entry> entryTable;
+        std::vector<Trigram> trigramTable;
+        std::string poolData;
+        for (uint32_t i = 0; i < records.size(); i++) {
+            const RepositoryRecord& record = records[i];
+            Entry entry{};
+            entry.offset = static_cast<uint32_t>(poolData.size());
+            entry.nameLength = static_cast<uint16_t>(std::min<size_t>(record.fullName.size(), 0xFFFF));
+            entry.languageLength = static_cast<uint16_t>(std::min<size_t>(record.language.size(), 0xFFFF));
+            entry.descriptionLength = static_cast<uint32_t>(record.description.size());
+            entry.topicsLength = static_cast<uint32_t>(record.topics.size());
+            entry.flags = record.isPrivate ? FlagPrivate : 0;
+            entry.pushedAt = record.pushedAt;
+            poolData += record.fullName.substr(0, entry.nameLength) + record.description + record.topics +
+                        record.language.substr(0, entry.languageLength);
+
+            // Текст для поиска в нижнем регистре: имя, описание и темы через перевод строки
+            std::string text = toLower(record.fullName.substr(0, entry.nameLength)) + "\n" +
+                               toLower(record.description) + "\n" + toLower(record.topics);
+            entry.searchOffset = static_cast<uint32_t>(poolData.size());
+            entry.searchLength = static_cast<uint32_t>(text.size());
+            poolData += text;
+            entryTable.push_back(entry);
+
+            for (uint32_t key : trigramsOf(text)) {
+                trigramTable.push_back({key, i});
+            }
+            header.newestPush = std::max<int64_t>(header.newestPush, record.pushedAt);
+        }
+
+        std::sort(trigramTable.begin(), trigramTable.end(), [](const Trigram& a, const Trigram& b) {
+            return a.key != b.key ? a.key < b.key : a.record < b.record;
+        });
+        header.trigramCount = static_cast<uint32_t>(trigramTable.size());
+        header.poolSize = static_cast<uint32_t>(poolData.size());
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(entryTable.data()), entryTable.size() * sizeof(Entry));
+            out.write(reinterpret_cast<const char*>(trigramTable.data()), trigramTable.size() * sizeof(Trigram));
+            out.write(poolData.data(), poolData.size());
+            if (!out) {
+                return false;
+            }
+        }
+        std::filesystem::rename(temp, path, ec);
+        return !ec;
+    }
+
+private:
+    static const uint32_t FlagPrivate = 1;
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint32_t trigramCount;
+        int64_t newestPush;
+        int64_t fullBuildAt;
+        uint32_t poolSize;
+        uint32_t reserved;
+    };
+
+    struct Entry {
+        uint32_t offset;            // Начало строк записи в пуле
+        uint16_t nameLength;
+        uint16_t languageLength;
+        uint32_t descriptionLength;
+        uint32_t topicsLength;
+        uint32_t searchOffset;      // Текст для поиска в нижнем регистре
+        uint32_t searchLength;
+        uint32_t flags;
+        int64_t pushedAt;
+    };
+
+    struct Trigram {
+        uint32_t key;
+        uint32_t record;
+    };
+
+    MappedFile file;
+    const Header* header = nullptr;
+    const Entry* entries = nullptr;
+    const Trigram* trigrams = nullptr;
+    const char* pool = nullptr;
+
+    std::string_view searchText(uint32_t index) const {
+        return std::string_view(pool + entries[index].searchOffset, entries[index].searchLength);
+    }
+
+    static std::string toLower(std::string text) {
+        for (char& c : text) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        return text;
+    }
+
+    // Уникальные триграммы текста (по байтам)
+    static std::vector<uint32_t> trigramsOf(const std::string& text) {
+        std::vector<uint32_t> keys;
+        for (size_t i = 0; i + 3 <= text.size(); i++) {
+            keys.push_back((static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << 16) |
+                           (static_cast<uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8) |
+                           static_cast<uint32_t>(static_cast<unsigned char>(text[i + 2])));
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    }
+
+    // Записи, содержащие все триграммы запроса (начиная с самого короткого списка)
+    std::vector<uint32_t> trigramCandidates(const std::string& needle) const {
+        std::vector<std::pair<const Trigram*, const Trigram*>> lists;
+        for (uint32_t key : trigramsOf(needle)) {
+            auto range = std::equal_range(trigrams, trigrams + header->trigramCount, Trigram{key, 0},
+                                          [](const Trigram& a, const Trigram& b) { return a.key < b.key; });
+            if (range.first == range.second) {
+                return {};
+            }
+            lists.push_back(range);
+        }
+        std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) {
+            return (a.second - a.first) < (b.second - b.first);
+        });
+
+        std::vector<uint32_t> result;
+        for (const Trigram* it = lists[0].first; it != lists[0].second; ++it) {
+            result.push_back(it->record);
+        }
+        for (size_t i = 1; i < lists.size() && !result.empty(); i++) {
+            std::vector<uint32_t> next;
+            const Trigram* it = lists[i].first;
+            for (uint32_t record : result) {
+                while (it != lists[i].second && it->record < record) {
+                    ++it;
+                }
+                if (it != lists[i].second && it->record == record) {
+                    next.push_back(record);
+                }
+            }
+            result.swap(next);
+        }
+        return result;
+    }
+};
+
+// Задача или pull request в локальной копии
+struct IssueItem {
+    long long number = 0;
+    bool pullRequest = false;
+    bool open = true;
+    long long updatedAt = 0;
+    long long comments = 0;
+    std::string title;
+    std::string author;
+    std::string milestone;
+    std::string body;
+    std::vector<std::string> labels;
+    std::vector<std::string> assignees;
+};
+
+// Условия отбора задач; пустые поля не ограничивают выборку
+struct IssueFilter {
+    std::string state = "open";   // open, closed, all
+    std::string kind = "all";     // issue, pr, all
+    std::string label;
+    std::string assignee;
+    std::string author;
+    std::string text;
+};
+
+// Локальная копия задач и pull request репозитория. Файл: заголовок
+// "github-manager-issues 1 <курсор updated_at> <время полной синхронизации> <число записей>",
+// затем для каждой записи строка с числовыми полями и длинами строк и сами строки.
+// Для отбора строятся индексы по состоянию, метке, исполнителю и триграммам текста
+class IssueStore {
+public:
+    bool load(const std::filesystem::path& path) {
+        items.clear();
+        cursor.clear();
+        fullSyncAt = 0;
+        std::ifstream file(path, std::ios::binary);
+        std::string magic;
+        int version = 0;
+        size_t count = 0;
+        if (!(file >> magic >> version >> cursor >> fullSyncAt >> count) || magic != "github-manager-issues" || version != 1) {
+            cursor.clear();
+            fullSyncAt = 0;
+            rebuildIndexes();
+            return false;
+        }
+        if (cursor == "-") {
+            cursor.clear();
+        }
+
+        items.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            IssueItem item;
+            int pullRequest = 0;
+            int open = 0;
+            size_t lengths[6];
+            if (!(file >> item.number >> pullRequest >> open >> item.updatedAt >> item.comments)) {
+                break;
+            }
+            for (size_t& length : lengths) {
+                file >> length;
+            }
+            file.get();
+            std::string labels, assignees;
+            std::string* fields[6] = {&item.title, &item.author, &item.milestone, &item.body, &labels, &assignees};
+            for (int f = 0; f < 6; f++) {
+                fields[f]->resize(lengths[f]);
+                file.read(&(*fields[f])[0], static_cast<std::streamsize>(lengths[f]));
+            }
+            if (!file) {
+                break;
+            }
+            item.pullRequest = pullRequest != 0;
+            item.open = open != 0;
+            item.labels = splitLines(labels);
+            item.assignees = splitLines(assignees);
+            items.push_back(std::move(item));
+        }
+        rebuildIndexes();
+        return true;
+    }
+
+    // Запись через временный файл: прерванное сохранение не портит прежнюю копию
+    bool save(const std::filesystem::path& path) const {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            file << "github-manager-issues 1 " << (cursor.empty() ? "-" : cursor) << " " << fullSyncAt << " "
+                 << items.size() << "\n";
+            for (const IssueItem& item : items) {
+                std::string labels = joinLines(item.labels);
+                std::string assignees = joinLines(item.assignees);
+                file << item.number << " " << item.pullRequest << " " << item.open << " " << item.updatedAt << " "
+                     << item.comments << " " << item.title.size() << " " << item.author.size() << " "
+                     << item.milestone.size() << " " << item.body.size() << " " << labels.size() << " "
+                     << assignees.size() << "\n"
+                     << item.title << item.author << item.milestone << item.body << labels << assignees;
+            }
+            if (!file) {
+                return false;
+            }
+        }
+        std::filesystem::rename(temp, path, ec);
+        return !ec;
+    }
+
+    // Добавление или замена записи с тем же номером
+    void upsert(IssueItem item) {
+        auto it = positions.find(item.number);
+        if (it != positions.end()) {
+            items[it->second] = std::move(item);
+        } else {
+            positions[item.number] = items.size();
+            items.push_back(std::move(item));
+        }
+        indexesValid = false;
+    }
+
+    // Замена всех записей (полная синхронизация: удаленные и перенесенные задачи исчезают)
+    void replaceAll(std::vector<IssueItem> values) {
+        items = std::move(values);
+        rebuildIndexes();
+    }
+
+    std::vector<const IssueItem*> query(const IssueFilter& filter) {
+        if (!indexesValid) {
+            rebuildIndexes();
+        }
+
+        // Кандидаты - самый короткий из подходящих индексов, остальные условия проверяются на месте
+        const std::vector<uint32_t>* candidates = nullptr;
+        auto narrow = [&candidates](const std::vector<uint32_t>* list) {
+            if (candidates == nullptr || list->size() < candidates->size()) {
+                candidates = list;
+            }
+        };
+        static const std::vector<uint32_t> none;
+        if (filter.state != "all") {
+            narrow(filter.state == "closed" ? &closedItems : &openItems);
+        }
+        if (!filter.label.empty()) {
+            auto it = byLabel.find(toLower(filter.label));
+            narrow(it != byLabel.end() ? &it->second : &none);
+        }
+        if (!filter.assignee.empty()) {
+            auto it = byAssignee.find(toLower(filter.assignee));
+            narrow(it != byAssignee.end() ? &it->second : &none);
+        }
+        std::string text = toLower(filter.text);
+        for (size_t i = 0; i + 3 <= text.size(); i++) {
+            auto it = byTrigram.find(trigramKey(text, i));
+            narrow(it != byTrigram.end() ? &it->second : &none);
+        }
+
+        std::vector<const IssueItem*> result;
+        auto check = [&](uint32_t index) {
+            const IssueItem& item = items[index];
+            if ((filter.state == "open" && !item.open) || (filter.state == "closed" && item.open) ||
+                (filter.kind == "pr" && !item.pullRequest) || (filter.kind == "issue" && item.pullRequest) ||
+                (!filter.label.empty() && !containsIgnoreCase(item.labels, filter.label)) ||
+                (!filter.assignee.empty() && !containsIgnoreCase(item.assignees, filter.assignee)) ||
+                (!filter.author.empty() && toLower(item.author) != toLower(filter.author)) ||
+                (!text.empty() && searchText[index].find(text) == std::string::npos)) {
+                return;
+            }
+            result.push_back(&item);
+        };
+        if (candidates != nullptr) {
+            for (uint32_t index : *candidates) {
+                check(index);
+            }
+        } else {
+            for (uint32_t index = 0; index < items.size(); index++) {
+                check(index);
+            }
+        }
+        std::sort(result.begin(), result.end(), [](const IssueItem* a, const IssueItem* b) {
+            return a->number > b->number;
+        });
+        return result;
+    }
+
+    const IssueItem* find(long long number) const {
+        auto it = positions.find(number);
+        return it != positions.end() ? &items[it->second] : nullptr;
+    }
+
+    size_t size() const {
+        return items.size();
+    }
+
+    std::string cursor;        // Наибольший updated_at синхронизированных записей (ISO 8601)
+    long long fullSyncAt = 0;
+
+private:
+    std::vector<IssueItem> items;
+    std::map<long long, size_t> positions;
+    std::vector<uint32_t> openItems;
+    std::vector<uint32_t> closedItems;
+    std::map<std::string, std::vector<uint32_t>> byLabel;
+    std::map<std::string, std::vector<uint32_t>> byAssignee;
+    std::map<uint32_t, std::vector<uint32_t>> byTrigram;
+    std::vector<std::string> searchText; // Заголовок и описание в нижнем регистре
+    bool indexesValid = false;
+
+    void rebuildIndexes() {
+        positions.clear();
+        openItems.clear();
+        closedItems.clear();
+        byLabel.clear();
+        byAssignee.clear();
+        byTrigram.clear();
+        searchText.clear();
+        searchText.reserve(items.size());
+        for (uint32_t index = 0; index < items.size(); index++) {
+            const IssueItem& item = items[index];
+            positions[item.number] = index;
+            (item.open ? openItems : closedItems).push_back(index);
+            for (const auto& label : item.labels) {
+                byLabel[toLower(label)].push_back(index);
+            }
+            for (const auto& assignee : item.assignees) {
+                byAssignee[toLower(assignee)].push_back(index);
+            }
+            searchText.push_back(toLower(item.title + "\n" + item.body));
+            const std::string& text = searchText.back();
+            for (size_t i = 0; i + 3 <= text.size(); i++) {
+                std::vector<uint32_t>& list = byTrigram[trigramKey(text, i)];
+                if (list.empty() || list.back() != index) {
+                    list.push_back(index);
+                }
+            }
+        }
+        indexesValid = true;
+    }
+
+    static uint32_t trigramKey(const std::string& text, size_t pos) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(text[pos])) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8) |
+               static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 2]));
+    }
+
+    static bool containsIgnoreCase(const std::vector<std::string>& values, const std::string& value) {
+        std::string lower = toLower(value);
+        return std::any_of(values.begin(), values.end(), [&lower](const std::string& item) {
+            return toLower(item) == lower;
+        });
+    }
+
+    static std::string toLower(std::string text) {
+        for (char& c : text) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        return text;
+    }
+
+    static std::string joinLines(const std::vector<std::string>& values) {
+        std::string result;
+        for (const auto& value : values) {
+            result += value + "\n";
+        }
+        return result;
+    }
+
+    static std::vector<std::string> splitLines(const std::string& text) {
+        std::vector<std::string> values;
+        std::istringstream stream(text);
+        std::string line;
+        while (std::getline(stream, line)) {
+            values.push_back(line);
+        }
+        return values;
+    }
+};
+
+// Запись о файле из "git status --porcelain=v2"; пути ссылаются на буфер WorkingTreeStatus
+struct StatusEntry {
+    char kind = '1';            // '1' - изменен, '2' - переименован/скопирован, 'u' - конфликт, '?' - неотслеживаемый
+    char indexStatus = '.';     // Состояние в индексе (X)
+    char worktreeStatus = '.';  // Состояние в рабочей копии (Y)
+    std::string_view path;
+    std::string_view originalPath; // Исходный путь для переименования
+};
+
+// Структурированное состояние рабочей копии.
+// Все строки - срезы одного общего буфера с выводом git, который живет вместе с копиями объекта
+struct WorkingTreeStatus {
+    std::shared_ptr<const std::string> buffer;
+    std::string_view branch;
+    std::string_view upstream;
+    bool hasUpstream = false;
+    int ahead = 0;
+    int behind = 0;
+    size_t staged = 0;
+    size_t unstaged = 0;
+    size_t untracked = 0;
+    size_t conflicted = 0;
+    std::vector<StatusEntry> entries;
+
+    bool isClean() const {
+        return entries.empty();
+    }
+
+    // Разбор вывода "git status --porcelain=v2 -z --branch": записи разделены символом NUL
+    static WorkingTreeStatus parse(std::string output) {
+        WorkingTreeStatus status;
+        status.buffer = std::make_shared<const std::string>(std::move(output));
+        NulRecordReader reader(*status.buffer);
+
+        // Пропуск заданного количества полей, разделенных пробелами; остаток - путь
+        auto skipFields = [](std::string_view record, int count) {
+            size_t offset = 0;
+            for (int i = 0; i < count && offset != std::string_view::npos; i++) {
+                offset = record.find(' ', offset);
+                if (offset != std::string_view::npos) {
+                    offset++;
+                }
+            }
+            return offset == std::string_view::npos ? std::string_view() : record.substr(offset);
+        };
+
+        std::string_view record;
+        while (reader.next(record)) {
+            if (record.size() < 2) {
+                continue;
+            }
+
+            if (record[0] == '#') {
+                std::string_view header = record.substr(2);
+                if (header.compare(0, 12, "branch.head ") == 0) {
+                    status.branch = header.substr(12);
+                } else if (header.compare(0, 16, "branch.upstream ") == 0) {
+                    status.upstream = header.substr(16);
+                    status.hasUpstream = true;
+                } else if (header.compare(0, 10, "branch.ab ") == 0) {
+                    // Формат: "+<ahead> -<behind>"
+                    std::string_view ab = header.substr(10);
+                    size_t space = ab.find(' ');
+                    if (ab.size() > 1 && space != std::string_view::npos && space + 2 <= ab.size()) {
+                        std::from_chars(ab.data() + 1, ab.data() + space, status.ahead);
+                        std::from_chars(ab.data() + space + 2, ab.data() + ab.size(), status.behind);
+                    }
+                }
+                continue;
+            }
+
+            StatusEntry entry;
+            entry.kind = record[0];
+
+            if (entry.kind == '!') {
+                continue; // Игнорируемые файлы не учитываются
+            } else if (entry.kind == '?') {
+                entry.path = record.substr(2);
+                status.untracked++;
+            } else if (record.size() >= 4) {
+                entry.indexStatus = record[2];
+                entry.worktreeStatus = record[3];
+
+                if (entry.kind == '1') {
+                    entry.path = skipFields(record, 8);
+                } else if (entry.kind == '2') {
+                    entry.path = skipFields(record, 9);
+                    reader.next(entry.originalPath);
+                } else if (entry.kind == 'u') {
+                    entry.path = skipFields(record, 10);
+                } else {
+                    continue;
+                }
+
+                if (entry.kind == 'u') {
+                    status.conflicted++;
+                } else {
+                    if (entry.indexStatus != '.') {
+                        status.staged++;
+                    }
+                    if (entry.worktreeStatus != '.') {
+                        status.unstaged++;
+                    }
+                }
+            } else {
+                continue;
+            }
+
+            status.entries.push_back(entry);
+        }
+
+        return status;
+    }
+};
+
+// Задача для массового импорта; index - порядковый номер записи в файле (с 1)
+struct IssueRecord {
+    size_t index = 0;
+    std::string title;
+    std::string body;
+    std::string milestone;
+    std::vector<std::string> labels;
+    std::vector<std::string> assignees;
+};
+
+// Потоковое чтение задач из CSV (первая строка - заголовок с колонками title, body, labels,
+// assignees, milestone; разделитель "," или ";") или JSON (массив объектов либо объекты по
+// одному на строку). В памяти находится только текущая запись
+class IssueImportReader {
+public:
+    explicit IssueImportReader(const std::filesystem::path& path) : input(path, std::ios::binary) {
+        if (!input) {
+            return;
+        }
+        // Пропуск метки порядка байтов UTF-8
+        if (input.peek() == 0xEF) {
+            char bom[3];
+            input.read(bom, 3);
+        }
+        while (std::isspace(input.peek())) {
+            input.get();
+        }
+        json = input.peek() == '[' || input.peek() == '{';
+        if (json && input.peek() == '[') {
+            input.get();
+        }
+    }
+
+    bool isOpen() const {
+        return input.is_open();
+    }
+
+    // Следующая запись; false - записи закончились. Ошибка разбора возвращается в error
+    // вместе с номером записи, чтение можно продолжать
+    bool next(IssueRecord& record, std::string& error) {
+        record = IssueRecord();
+        error.clear();
+        bool found = json ? nextJson(record, error) : nextCsv(record, error);
+        if (found) {
+            record.index = ++recordCount;
+            if (error.empty() && record.title.empty()) {
+                error = "нет заголовка (title)";
+            }
+        }
+        return found;
+    }
+
+private:
+    std::ifstream input;
+    bool json = false;
+    size_t recordCount = 0;
+    char delimiter = ',';
+    std::vector<std::string> columns;
+
+    // Значения списков в одной ячейке или строке JSON разделяются запятой, точкой с запятой или "|"
+    static std::vector<std::string> splitList(const std::string& text) {
+        std::vector<std::string> items;
+        std::string current;
+        for (char c : text + ",") {
+            if (c == ',' || c == ';' || c == '|') {
+                size_t begin = current.find_first_not_of(" \t");
+                if (begin != std::string::npos) {
+                    items.push_back(current.substr(begin, current.find_last_not_of(" \t") - begin + 1));
+                }
+                current.clear();
+            } else {
+                current += c;
+            }
+        }
+        return items;
+    }
+
+    // Строка CSV с учетом кавычек (поле в кавычках может содержать разделители и переводы строк)
+    bool readCsvRow(std::vector<std::string>& fields) {
+        fields.clear();
+        if (input.peek() == std::char_traits<char>::eof()) {
+            return false;
+        }
+        std::string field;
+        bool quoted = false;
+        int c;
+        while ((c = input.get()) != std::char_traits<char>::eof()) {
+            if (quoted) {
+                if (c == '"' && input.peek() == '"') {
+                    field += static_cast<char>(input.get());
+                } else if (c == '"') {
+                    quoted = false;
+                } else {
+                    field += static_cast<char>(c);
+                }
+            } else if (c == '"') {
+                quoted = true;
+            } else if (c == delimiter) {
+                fields.push_back(field);
+                field.clear();
+            } else if (c == '\n') {
+                break;
+            } else if (c != '\r') {
+                field += static_cast<char>(c);
+            }
+        }
+        fields.push_back(field);
+        return true;
+    }
+
+    bool nextCsv(IssueRecord& record, std::string& error) {
+        if (columns.empty()) {
+            std::string header;
+            std::streampos start = input.tellg();
+            std::getline(input, header);
+            delimiter = std::count(header.begin(), header.end(), ';') > std::count(header.begin(), header.end(), ',')
+                        ? ';' : ',';
+            input.clear();
+            input.seekg(start);
+            if (!readCsvRow(columns)) {
+                return false;
+            }
+            for (auto& column : columns) {
+                column = trim(column);
+                std::transform(column.begin(), column.end(), column.begin(),
+                               [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            }
+        }
+
+        std::vector<std::string> fields;
+        do {
+            if (!readCsvRow(fields)) {
+                return false;
+            }
+        } while (fields.size() == 1 && trim(fields[0]).empty()); // Пустые строки пропускаются
+
+        if (fields.size() > columns.size()) {
+            error = "лишние поля в строке";
+        }
+        for (size_t i = 0; i < fields.size() && i < columns.size(); i++) {
+            const std::string& column = columns[i];
+            if (column == "title") {
+                record.title = trim(fields[i]);
+            } else if (column == "body") {
+                record.body = fields[i];
+            } else if (column == "labels") {
+                record.labels = splitList(fields[i]);
+            } else if (column == "assignees") {
+                record.assignees = splitList(fields[i]);
+            } else if (column == "milestone") {
+                record.milestone = trim(fields[i]);
+            }
+        }
+        return true;
+    }
+
+    // Текст очередного объекта верхнего уровня выделяется по глубине вложенности
+    // и разбирается отдельно, поэтому размер файла не ограничен памятью
+    bool nextJson(IssueRecord& record, std::string& error) {
+        std::string text;
+        int depth = 0;
+        bool inString = false;
+        int c;
+        while ((c = input.get()) != std::char_traits<char>::eof()) {
+            if (depth == 0) {
+                if (c == '{') {
+                    depth = 1;
+                    text = "{";
+                }
+                continue; // Запятые, пробелы и закрывающая скобка массива между объектами
+            }
+            text += static_cast<char>(c);
+            if (inString) {
+                if (c == '\\') {
+                    int escaped = input.get();
+                    if (escaped != std::char_traits<char>::eof()) {
+                        text += static_cast<char>(escaped);
+                    }
+                } else if (c == '"') {
+                    inString = false;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                break;
+            }
+        }
+        if (text.empty()) {
+            return false;
+        }
+
+        JsonDocument document(text);
+        if (!document.isValid() || depth != 0) {
+            error = "некорректный JSON";
+            return true;
+        }
+        JsonDocument::Value root = document.root();
+        record.title = trim(root["title"].asString());
+        record.body = root["body"].asString();
+        record.milestone = trim(root["milestone"].asString());
+        record.labels = readList(root["labels"]);
+        record.assignees = readList(root["assignees"]);
+        return true;
+    }
+
+    // Список задается массивом строк (для меток - также объектов с полем name) или строкой
+    static std::vector<std::string> readList(const JsonDocument::Value& value) {
+        if (!value.isArray()) {
+            return splitList(value.asString());
+        }
+        std::vector<std::string> items;
+        value.forEach([&items](const JsonDocument::Value& item) {
+            std::string text = item.isObject() ? item["name"].asString() : item.asString();
+            if (!text.empty()) {
+                items.push_back(text);
+            }
+        });
+        return items;
+    }
+
+    static std::string trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        return begin == std::string::npos ? "" : text.substr(begin, text.find_last_not_of(" \t\r\n") - begin + 1);
+    }
+};
+
+// Журнал импорта: ключи уже созданных записей. Запись добавляется сразу после создания
+// задачи, поэтому прерванный импорт продолжается без повторного создания. Ключ зависит
+// от содержимого записи, а не от ее номера: строки исправленного файла можно добавлять,
+// удалять и переставлять
+class ImportJournal {
+public:
+    explicit ImportJournal(std::filesystem::path path) : path(std::move(path)) {
+        std::ifstream file(this->path);
+        std::string key;
+        long long number = 0;
+        while (file >> key >> number) {
+            if (key.find(':') != std::string::npos) {
+                done[key] = number;
+            }
+        }
+    }
+
+    // Ключ записи: хеш заголовка и текста и номер повторения одинаковой записи в файле
+    static std::string key(const std::string& title, const std::string& body, size_t occurrence) {
+        uint64_t hash = 1469598103934665603ULL;
+        for (const std::string* part : {&title, &body}) {
+            for (char c : *part) {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+            }
+            hash = (hash ^ 0xFFu) * 1099511628211ULL; // Разделитель: "ab"+"c" не совпадает с "a"+"bc"
+        }
+        std::ostringstream stream;
+        stream << std::hex << hash << ":" << std::dec << occurrence;
+        return stream.str();
+    }
+
+    size_t size() const {
+        return done.size();
+    }
+
+    bool contains(const std::string& key) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return done.count(key) > 0;
+    }
+
+    void record(const std::string& key, long long number) {
+        std::lock_guard<std::mutex> lock(mutex);
+        done[key] = number;
+        if (!output.is_open()) {
+            std::filesystem::create_directories(path.parent_path());
+            output.open(path, std::ios::app);
+        }
+        output << key << " " << number << "\n";
+        output.flush();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        output.close();
+        done.clear();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+private:
+    std::filesystem::path path;
+    std::map<std::string, long long> done;
+    std::ofstream output;
+    mutable std::mutex mutex;
+};
+
+// Текстовый шаблон с подстановками {{имя}}. Шаблон разбирается один раз при создании,
+// после чего render() только склеивает готовые фрагменты и значения
+class TextTemplate {
+public:
+    explicit TextTemplate(std::string text) : source(std::move(text)) {
+        size_t pos = 0;
+        while (pos < source.size()) {
+            size_t open = source.find("{{", pos);
+            size_t close = open == std::string::npos ? std::string::npos : source.find("}}", open + 2);
+            if (close == std::string::npos) {
+                segments.push_back({false, source.substr(pos)});
+                break;
+            }
+            if (open > pos) {
+                segments.push_back({false, source.substr(pos, open - pos)});
+            }
+            segments.push_back({true, source.substr(open + 2, close - open - 2)});
+            pos = close + 2;
+        }
+    }
+
+    // Неизвестные подстановки заменяются пустой строкой
+    std::string render(const std::map<std::string, std::string>& values) const {
+        std::string result;
+        result.reserve(source.size());
+        for (const Segment& segment : segments) {
+            if (!segment.placeholder) {
+                result += segment.text;
+                continue;
+            }
+            auto it = values.find(segment.text);
+            if (it != values.end()) {
+                result += it->second;
+            }
+        }
+        return result;
+    }
+
+private:
+    struct Segment {
+        bool placeholder;
+        std::string text;
+    };
+
+    std::string source;
+    std::vector<Segment> segments;
+};
+
+// Файл для копирования в проект. hash = 0 - содержимое не хешировалось
+struct SeedFile {
+    std::filesystem::path source;
+    std::filesystem::path relative;
+    uintmax_t size = 0;
+    uint64_t hash = 0;
+
+    // FNV-1a по содержимому файла; 0 - файл не прочитан
+    static uint64_t hashFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return 0;
+        }
+        uint64_t hash = 1469598103934665603ULL;
+        char buffer[65536];
+        while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+            for (std::streamsize i = 0; i < file.gcount(); i++) {
+                hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 1099511628211ULL;
+            }
+        }
+        return hash;
+    }
+
+    // Все файлы директории-заготовки (кроме .git) с размерами и хешами
+    static std::vector<SeedFile> collect(const std::filesystem::path& directory) {
+        std::vector<SeedFile> files;
+        std::error_code ec;
+        for (auto it = std::filesystem::recursive_directory_iterator(directory, ec);
+             it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (ec) {
+                break;
+            }
+            if (it->is_directory() && it->path().filename() == ".git") {
+                it.disable_recursion_pending();
+                continue;
+            }
+            if (!it->is_regular_file()) {
+                continue;
+            }
+            SeedFile file;
+            file.source = it->path();
+            file.relative = std::filesystem::relative(it->path(), directory);
+            file.size = it->file_size();
+            file.hash = hashFile(it->path());
+            files.push_back(std::move(file));
+        }
+        return files;
+    }
+};
+
+// Локальное хранилище шаблонов .gitignore (github/gitignore). Версия - идентификатор дерева
+// репозитория шаблонов: при устаревании проверяется только он, и шаблоны загружаются заново,
+// лишь если дерево изменилось. Формат: заголовок
+// "github-manager-templates 1 <версия> <время загрузки> <число шаблонов>",
+// затем для каждого шаблона строка "<длина имени> <длина текста>" и сами данные
+class TemplateStore {
+public:
+    bool load(const std::filesystem::path& path) {
+        templates.clear();
+        byLowerName.clear();
+        std::ifstream file(path, std::ios::binary);
+        std::string magic;
+        int formatVersion = 0;
+        size_t count = 0;
+        if (!(file >> magic >> formatVersion >> version >> fetchedAt >> count) ||
+            magic != "github-manager-templates" || formatVersion != 1) {
+            version.clear();
+            fetchedAt = 0;
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t nameLength = 0;
+            size_t textLength = 0;
+            if (!(file >> nameLength >> textLength)) {
+                break;
+            }
+            file.get();
+            std::string name(nameLength, '\0');
+            std::string text(textLength, '\0');
+            file.read(&name[0], static_cast<std::streamsize>(nameLength));
+            file.read(&text[0], static_cast<std::streamsize>(textLength));
+            if (!file) {
+                break;
+            }
+            add(name, std::move(text));
+        }
+        return true;
+    }
+
+    bool save(const std::filesystem::path& path) const {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            file << "github-manager-templates 1 " << (version.empty() ? "-" : version) << " " << fetchedAt << " "
+                 << templates.size() << "\n";
+            for (const auto& entry : templates) {
+                file << entry.first.size() << " " << entry.second.size() << "\n" << entry.first << entry.second;
+            }
+            if (!file) {
+                return false;
+            }
+        }
+        std::filesystem::rename(temp, path, ec);
+        return !ec;
+    }
+
+    void replace(std::map<std::string, std::string> values, const std::string& newVersion, long long time) {
+        templates.clear();
+        byLowerName.clear();
+        for (auto& entry : values) {
+            add(entry.first, std::move(entry.second));
+        }
+        version = newVersion;
+        fetchedAt = time;
+    }
+
+    // Поиск шаблона по имени без учета регистра; nullptr - нет такого шаблона
+    const std::string* find(const std::string& name) const {
+        auto it = byLowerName.find(toLower(name));
+        return it != byLowerName.end() ? &templates.at(it->second) : nullptr;
+    }
+
+    // Имена шаблонов, содержащие подстроку (без учета регистра)
+    std::vector<std::string> search(const std::string& query) const {
+        std::vector<std::string> names;
+        std::string lowerQuery = toLower(query);
+        for (const auto& entry : byLowerName) {
+            if (entry.first.find(lowerQuery) != std::string::npos) {
+                names.push_back(entry.second);
+            }
+        }
+        return names;
+    }
+
+    bool empty() const {
+        return templates.empty();
+    }
+
+    std::string version;
+    long long fetchedAt = 0;
+
+private:
+    std::map<std::string, std::string> templates;
+    std::map<std::string, std::string> byLowerName;
+
+    void add(const std::string& name, std::string text) {
+        byLowerName[toLower(name)] = name;
+        templates[name] = std::move(text);
+    }
+
+    static std::string toLower(std::string text) {
+        for (char& c : text) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        return text;
+    }
+};
+
+// Каталог локальных зеркал (bare-репозиториев) для повторного клонирования.
+// Зеркало обновляется под собственной блокировкой, поэтому параллельные клоны
+// одного репозитория не обновляют его одновременно
+class MirrorCache {
+public:
+    explicit MirrorCache(std::filesystem::path root) : root(std::move(root)) {}
+
+    // Путь зеркала: имя репозитория и хеш адреса (разные хосты и владельцы не пересекаются)
+    std::filesystem::path pathFor(const std::string& url) const {
+        return root / (repositoryName(url) + "-" + std::to_string(std::hash<std::string>()(url)) + ".git");
+    }
+
+    // Имя репозитория из адреса или пути: последний компонент без ".git"
+    static std::string repositoryName(std::string url) {
+        while (!url.empty() && (url.back() == '/' || url.back() == '\\')) {
+            url.pop_back();
+        }
+        size_t start = url.find_last_of("/\\:");
+        std::string name = start == std::string::npos ? url : url.substr(start + 1);
+        const std::string suffix = ".git";
+        if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            name.resize(name.size() - suffix.size());
+        }
+        return name;
+    }
+
+    // Владелец из owner/name, адреса или пути: компонент перед именем репозитория
+    static std::string ownerName(std::string url) {
+        while (!url.empty() && (url.back() == '/' || url.back() == '\\')) {
+            url.pop_back();
+        }
+        size_t nameStart = url.find_last_of("/\\:");
+        if (nameStart == std::string::npos) {
+            return "";
+        }
+        url.resize(nameStart);
+        size_t start = url.find_last_of("/\\:");
+        return start == std::string::npos ? url : url.substr(start + 1);
+    }
+
+    std::unique_lock<std::mutex> lock(const std::filesystem::path& mirror) {
+        std::lock_guard<std::mutex> guard(mutex);
+        std::unique_ptr<std::mutex>& entry = locks[mirror.string()];
+        if (!entry) {
+            entry = std::make_unique<std::mutex>();
+        }
+        return std::unique_lock<std::mutex>(*entry);
+    }
+
+    const std::filesystem::path& getRoot() const { return root; }
+
+private:
+    std::filesystem::path root;
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<std::mutex>> locks;
+};
+
+// Профиль клонирования: глубина истории, частичное клонирование, sparse-checkout
+struct CloneProfile {
+    int depth = 0;                         // 0 - вся история
+    std::string filter;                    // blob:none, tree:0 или пусто
+    std::string branch;                    // пусто - ветка по умолчанию
+    bool singleBranch = false;
+    std::vector<std::string> sparsePaths;  // директории для sparse-checkout (режим cone)
+
+    bool isFull() const {
+        return depth == 0 && filter.empty() && !singleBranch && sparsePaths.empty();
+    }
+
+    // Ключи git clone; checkout.workers задается в новом репозитории до первого checkout
+    std::string cloneOptions(int checkoutWorkers) const {
+        std::string options = "--config checkout.workers=" + std::to_string(checkoutWorkers) + " ";
+        if (depth > 0) {
+            options += "--depth " + std::to_string(depth) + " ";
+        }
+        if (!filter.empty()) {
+            options += "--filter=" + filter + " ";
+        }
+        if (!branch.empty()) {
+            options += "--branch \"" + branch + "\" ";
+        }
+        if (singleBranch) {
+            options += "--single-branch ";
+        }
+        if (!sparsePaths.empty()) {
+            options += "--sparse ";
+        }
+        return options;
+    }
+
+    // Аргументы git для выбора директорий после клонирования (пустая строка - не нужны)
+    std::string sparseArguments(const std::string& target) const {
+        if (sparsePaths.empty()) {
+            return "";
+        }
+        std::string command = "-C \"" + target + "\" sparse-checkout set --cone";
+        for (const std::string& path : sparsePaths) {
+            command += " \"" + path + "\"";
+        }
+        return command;
+    }
+};
+
+// Репозиторий рабочего пространства
+struct WorkspaceRepository {
+    std::string path;    // рабочая директория (UTF-8)
+    std::string name;    // имя директории
+    std::string origin;  // адрес remote origin (если есть)
+    std::string kind;    // repository, worktree или submodule
+};
+
+// Индекс репозиториев в корневых директориях рабочего пространства. Директории обходятся
+// параллельно; для каждой запоминаются время изменения и список поддиректорий, поэтому при
+// обновлении перечитываются только директории, в которых что-то создано, удалено или
+// переименовано. Внутрь репозиториев обход не спускается: рабочие копии git worktree и
+// подмодули берутся из метаданных репозитория (.git/worktrees, .gitmodules)
+class WorkspaceIndex {
+public:
+    struct RefreshStats {
+        size_t directories = 0;  // просмотрено директорий
+        size_t listed = 0;       // из них прочитано (изменились с прошлого обхода)
+    };
+
+    bool load(const std::filesystem::path& path) {
+        directories.clear();
+        repositories.clear();
+        std::ifstream file(path, std::ios::binary);
+        std::string magic;
+        int version = 0;
+        size_t directoryCount = 0, repositoryCount = 0;
+        if (!(file >> magic >> version >> directoryCount >> repositoryCount) ||
+            magic != "github-manager-workspace" || version != 1) {
+            return false;
+        }
+        for (size_t i = 0; i < directoryCount; i++) {
+            DirectoryEntry entry;
+            int repository = 0;
+            size_t pathLength = 0, childrenLength = 0;
+            if (!(file >> entry.mtime >> repository >> pathLength >> childrenLength)) {
+                return false;
+            }
+            file.get();
+            std::string directory(pathLength, '\0'), children(childrenLength, '\0');
+            file.read(&directory[0], static_cast<std::streamsize>(pathLength));
+            file.read(&children[0], static_cast<std::streamsize>(childrenLength));
+            entry.repository = repository != 0;
+            std::istringstream stream(children);
+            for (std::string child; std::getline(stream, child);) {
+                entry.children.push_back(child);
+            }
+            directories[directory] = std::move(entry);
+        }
+        for (size_t i = 0; i < repositoryCount; i++) {
+            WorkspaceRepository repository;
+            size_t lengths[4];
+            for (size_t& length : lengths) {
+                file >> length;
+            }
+            file.get();
+            std::string* fields[4] = {&repository.path, &repository.name, &repository.origin, &repository.kind};
+            for (int f = 0; f < 4; f++) {
+                fields[f]->resize(lengths[f]);
+                file.read(&(*fields[f])[0], static_cast<std::streamsize>(lengths[f]));
+            }
+            if (!file) {
+                break;
+            }
+            repositories.push_back(std::move(repository));
+        }
+        return true;
+    }
+
+    // Запись через временный файл: прерванное сохранение не портит прежнюю копию
+    bool save(const std::filesystem::path& path) const {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            file << "github-manager-workspace 1 " << directories.size() << " " << repositories.size() << "\n";
+            for (const auto& directory : directories) {
+                std::string children;
+                for (const std::string& child : directory.second.children) {
+                    children += child + "\n";
+                }
+                file << directory.second.mtime << " " << directory.second.repository << " "
+                     << directory.first.size() << " " << children.size() << "\n" << directory.first << children;
+            }
+            for (const WorkspaceRepository& repository : repositories) {
+                file << repository.path.size() << " " << repository.name.size() << " " << repository.origin.size()
+                     << " " << repository.kind.size() << "\n"
+                     << repository.path << repository.name << repository.origin << repository.kind;
+            }
+            if (!file) {
+                return false;
+            }
+        }
+        std::filesystem::rename(temp, path, ec);
+        return !ec;
+    }
+
+    // Обход корневых директорий на глубину maxDepth в threadCount потоков
+    RefreshStats refresh(const std::vector<std::filesystem::path>& roots, int maxDepth, unsigned threadCount) {
+        RefreshStats stats;
+        std::map<std::string, DirectoryEntry> scanned;
+        std::map<std::string, WorkspaceRepository> found;
+        std::deque<std::pair<std::filesystem::path, int>> queue;
+        size_t active = 0;
+        std::mutex mutex;
+        std::condition_variable ready;
+        for (const auto& root : roots) {
+            queue.emplace_back(root, 0);
+        }
+
+        // Прежний индекс во время обхода только читается
+        auto worker = [&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                ready.wait(lock, [&]() { return !queue.empty() || active == 0; });
+                if (queue.empty()) {
+                    return;
+                }
+                std::pair<std::filesystem::path, int> item = std::move(queue.front());
+                queue.pop_front();
+                active++;
+                lock.unlock();
+
+                const std::filesystem::path& directory = item.first;
+                std::string key = directory.u8string();
+                std::error_code ec;
+                long long mtime = static_cast<long long>(
+                    std::filesystem::last_write_time(directory, ec).time_since_epoch().count());
+                DirectoryEntry entry;
+                bool listed = false;
+                std::vector<WorkspaceRepository> repositoriesHere;
+                if (!ec) {
+                    auto cached = directories.find(key);
+                    if (cached != directories.end() && cached->second.mtime == mtime) {
+                        entry = cached->second;
+                    } else {
+                        entry = listDirectory(directory, mtime);
+                        listed = true;
+                    }
+                    if (entry.repository) {
+                        repositoriesHere = describeRepository(directory);
+                    }
+                }
+
+                lock.lock();
+                active--;
+                if (!ec) {
+                    stats.directories++;
+                    stats.listed += listed ? 1 : 0;
+                    for (WorkspaceRepository& repository : repositoriesHere) {
+                        found.emplace(repository.path, std::move(repository));
+                    }
+                    if (!entry.repository && item.second < maxDepth) {
+                        for (const std::string& child : entry.children) {
+                            queue.emplace_back(directory / std::filesystem::u8path(child), item.second + 1);
+                        }
+                    }
+                    scanned[key] = std::move(entry);
+                }
+                ready.notify_all();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < std::max(1u, threadCount); i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+
+        directories = std::move(scanned);
+        repositories.clear();
+        for (auto& repository : found) {
+            repositories.push_back(std::move(repository.second));
+        }
+        return stats;
+    }
+
+    // Сброс запомненных директорий: следующий обход прочитает все заново
+    void invalidate() {
+        directories.clear();
+    }
+
+    // Поиск по имени, адресу origin и пути; точные совпадения имени - первыми
+    std::vector<const WorkspaceRepository*> find(const std::string& query) const {
+        std::string needle = toLower(query);
+        std::vector<const WorkspaceRepository*> exact, partial;
+        for (const WorkspaceRepository& repository : repositories) {
+            if (toLower(repository.name) == needle) {
+                exact.push_back(&repository);
+            } else if (toLower(repository.name).find(needle) != std::string::npos ||
+                       toLower(repository.origin).find(needle) != std::string::npos ||
+                       toLower(repository.path).find(needle) != std::string::npos) {
+                partial.push_back(&repository);
+            }
+        }
+        exact.insert(exact.end(), partial.begin(), partial.end());
+        return exact;
+    }
+
+    const std::vector<WorkspaceRepository>& getRepositories() const {
+        return repositories;
+    }
+
+    // Служебная директория рабочей копии: для worktree и подмодулей .git - файл со ссылкой "gitdir:"
+    static std::filesystem::path gitDirectory(const std::filesystem::path& workTree) {
+        std::error_code ec;
+        std::filesystem::path gitDir = workTree / ".git";
+        if (!std::filesystem::is_directory(gitDir, ec)) {
+            std::string link = trim(readFile(gitDir));
+            if (link.rfind("gitdir:", 0) == 0) {
+                gitDir = std::filesystem::u8path(trim(link.substr(7)));
+                if (gitDir.is_relative()) {
+                    gitDir = workTree / gitDir;
+                }
+            }
+        }
+        return gitDir.lexically_normal();
+    }
+
+    // Директория с config и общими ссылками (для worktree - путь из commondir)
+    static std::filesystem::path commonGitDirectory(const std::filesystem::path& workTree) {
+        std::filesystem::path gitDir = gitDirectory(workTree);
+        std::string common = trim(readFile(gitDir / "commondir"));
+        if (!common.empty()) {
+            std::filesystem::path commonDir = std::filesystem::u8path(common);
+            gitDir = commonDir.is_relative() ? gitDir / commonDir : commonDir;
+        }
+        return gitDir.lexically_normal();
+    }
+
+    // Адрес remote origin из config репозитория
+    static std::string readOriginUrl(const std::filesystem::path& gitDir) {
+        std::istringstream config(readFile(gitDir / "config"));
+        bool inOrigin = false;
+        for (std::string line; std::getline(config, line);) {
+            line = trim(line);
+            if (!line.empty() && line[0] == '[') {
+                inOrigin = line == "[remote \"origin\"]";
+            } else if (inOrigin && line.rfind("url", 0) == 0) {
+                size_t equals = line.find('=');
+                if (equals != std::string::npos) {
+                    return trim(line.substr(equals + 1));
+                }
+            }
+        }
+        return "";
+    }
+
+private:
+    struct DirectoryEntry {
+        long long mtime = 0;
+        bool repository = false;
+        std::vector<std::string> children;
+    };
+
+    static std::string toLower(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+        return text;
+    }
+
+    // Служебные и скрытые директории не обходятся
+    static bool isSkipped(const std::string& name) {
+        return name.empty() || name[0] == '.' || name[0] == '$' || name == "node_modules";
+    }
+
+    static DirectoryEntry listDirectory(const std::filesystem::path& directory, long long mtime) {
+        DirectoryEntry entry;
+        entry.mtime = mtime;
+        std::error_code ec;
+        entry.repository = std::filesystem::exists(directory / ".git", ec);
+        if (entry.repository) {
+            return entry;
+        }
+        for (std::filesystem::directory_iterator it(directory, std::filesystem::directory_options::skip_permission_denied, ec), end;
+             !ec && it != end; it.increment(ec)) {
+            std::error_code typeError;
+            if (it->is_directory(typeError) && !it->is_symlink(typeError)) {
+                std::string name = it->path().filename().u8string();
+                if (!isSkipped(name)) {
+                    entry.children.push_back(name);
+                }
+            }
+        }
+        return entry;
+    }
+
+    static std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    static std::string trim(const std::string& text) {
+        size_t start = text.find_first_not_of(" \t\r\n");
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return start == std::string::npos ? "" : text.substr(start, end - start + 1);
+    }
+
+    static WorkspaceRepository makeRepository(const std::filesystem::path& workTree, const std::string& kind) {
+        WorkspaceRepository repository;
+        repository.path = workTree.lexically_normal().u8string();
+        repository.name = workTree.filename().u8string();
+        repository.origin = readOriginUrl(commonGitDirectory(workTree));
+        repository.kind = kind;
+        return repository;
+    }
+
+    // Репозиторий, его рабочие копии worktree и подмодули первого уровня
+    static std::vector<WorkspaceRepository> describeRepository(const std::filesystem::path& workTree) {
+        std::vector<WorkspaceRepository> result;
+        std::error_code ec;
+        std::filesystem::path gitDir = workTree / ".git";
+        if (!std::filesystem::is_directory(gitDir, ec)) {
+            std::string link = readFile(gitDir);
+            result.push_back(makeRepository(workTree, link.find("/worktrees/") != std::string::npos ? "worktree" :
+                                                      link.find("/modules/") != std::string::npos ? "submodule" : "repository"));
+            return result;
+        }
+        result.push_back(makeRepository(workTree, "repository"));
+
+        for (std::filesystem::directory_iterator it(gitDir / "worktrees", ec), end; !ec && it != end; it.increment(ec)) {
+            std::filesystem::path link = std::filesystem::u8path(trim(readFile(it->path() / "gitdir")));
+            std::error_code existsError;
+            if (!link.empty() && std::filesystem::exists(link, existsError)) {
+                result.push_back(makeRepository(link.parent_path(), "worktree"));
+            }
+        }
+
+        std::istringstream modules(readFile(workTree / ".gitmodules"));
+        for (std::string line; std::getline(modules, line);) {
+            line = trim(line);
+            size_t equals = line.find('=');
+            if (line.rfind("path", 0) == 0 && equals != std::string::npos) {
+                std::filesystem::path submodule = workTree / std::filesystem::u8path(trim(line.substr(equals + 1)));
+                std::error_code existsError;
+                if (std::filesystem::exists(submodule / ".git", existsError)) {
+                    result.push_back(makeRepository(submodule, "submodule"));
+                }
+            }
+        }
+        return result;
+    }
+
+    std::map<std::string, DirectoryEntry> directories;
+    std::vector<WorkspaceRepository> repositories;
+};
+
+// Состояние репозитория в сводке рабочего пространства
+struct DashboardEntry {
+    std::string path;
+    std::string branch;
+    std::string upstream;      // например, origin/main; пусто - нет
+    int ahead = 0;
+    int behind = 0;
+    size_t staged = 0;
+    size_t unstaged = 0;
+    size_t untracked = 0;
+    size_t conflicted = 0;
+    long long lastFetch = 0;   // время последнего git fetch (секунды), 0 - не было
+    long long computedAt = 0;  // время расчета (секунды)
+    bool failed = false;
+    std::string signature;     // отпечаток служебных файлов git на момент расчета
+
+    bool isDirty() const {
+        return staged + unstaged + untracked + conflicted > 0;
+    }
+};
+
+// Кэш сводки рабочего пространства. Запись считается актуальной, пока не изменились служебные
+// файлы git (HEAD, index, FETCH_HEAD, журнал HEAD, ссылки ветки и upstream) и не истек срок
+// для правок в рабочей копии, которые в служебных файлах не видны
+class DashboardCache {
+public:
+    bool load(const std::filesystem::path& path) {
+        entries.clear();
+        std::ifstream file(path, std::ios::binary);
+        std::string magic;
+        int version = 0;
+        size_t count = 0;
+        if (!(file >> magic >> version >> count) || magic != "github-manager-dashboard" || version != 1) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            DashboardEntry entry;
+            int failed = 0;
+            size_t lengths[4];
+            if (!(file >> entry.ahead >> entry.behind >> entry.staged >> entry.unstaged >> entry.untracked
+                       >> entry.conflicted >> entry.lastFetch >> entry.computedAt >> failed)) {
+                break;
+            }
+            for (size_t& length : lengths) {
+                file >> length;
+            }
+            file.get();
+            std::string* fields[4] = {&entry.path, &entry.branch, &entry.upstream, &entry.signature};
+            for (int f = 0; f < 4; f++) {
+                fields[f]->resize(lengths[f]);
+                file.read(&(*fields[f])[0], static_cast<std::streamsize>(lengths[f]));
+            }
+            if (!file) {
+                break;
+            }
+            entry.failed = failed != 0;
+            entries[entry.path] = std::move(entry);
+        }
+        return true;
+    }
+
+    // Запись через временный файл: прерванное сохранение не портит прежнюю копию
+    bool save(const std::filesystem::path& path) const {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            file << "github-manager-dashboard 1 " << entries.size() << "\n";
+            for (const auto& item : entries) {
+                const DashboardEntry& entry = item.second;
+                file << entry.ahead << " " << entry.behind << " " << entry.staged << " "
+                     << entry.unstaged << " " << entry.untracked << " " << entry.conflicted << " " << entry.lastFetch << " "
+                     << entry.computedAt << " " << entry.failed << " " << entry.path.size() << " " << entry.branch.size()
+                     << " " << entry.upstream.size() << " " << entry.signature.size() << "\n"
+                     << entry.path << entry.branch << entry.upstream << entry.signature;
+            }
+            if (!file) {
+                return false;
+            }
+        }
+        std::filesystem::rename(temp, path, ec);
+        return !ec;
+    }
+
+    // Отпечаток служебных файлов; ветка и upstream берутся из предыдущего расчета
+    static std::string signature(const std::filesystem::path& workTree, const DashboardEntry* previous) {
+        std::filesystem::path gitDir = WorkspaceIndex::gitDirectory(workTree);
+        std::filesystem::path commonDir = WorkspaceIndex::commonGitDirectory(workTree);
+        std::vector<std::filesystem::path> files = {
+            gitDir / "HEAD", gitDir / "index", gitDir / "FETCH_HEAD", gitDir / "logs" / "HEAD", commonDir / "packed-refs",
+        };
+        if (previous != nullptr && !previous->branch.empty()) {
+            files.push_back(commonDir / "refs" / "heads" / std::filesystem::u8path(previous->branch));
+        }
+        if (previous != nullptr && !previous->upstream.empty()) {
+            files.push_back(commonDir / "refs" / "remotes" / std::filesystem::u8path(previous->upstream));
+        }
+        std::string result;
+        for (const auto& file : files) {
+            result += std::to_string(modificationTime(file)) + ",";
+        }
+        return result;
+    }
+
+    static long long modificationTime(const std::filesystem::path& path) {
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(path, ec);
+        return ec ? 0 : static_cast<long long>(time.time_since_epoch().count());
+    }
+
+    // Актуальная запись или nullptr, если репозиторий нужно пересчитать
+    const DashboardEntry* findFresh(const std::string& path, const std::string& currentSignature,
+                                    long long now, long long ttl) const {
+        auto it = entries.find(path);
+        if (it == entries.end() || it->second.failed || it->second.signature != currentSignature ||
+            now - it->second.computedAt > ttl) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    const DashboardEntry* find(const std::string& path) const {
+        auto it = entries.find(path);
+        return it == entries.end() ? nullptr : &it->second;
+    }
+
+    void store(DashboardEntry entry) {
+        std::string path = entry.path;
+        entries[path] = std::move(entry);
+    }
+
+    // Удаление записей репозиториев, которых больше нет в рабочем пространстве
+    void retain(const std::vector<WorkspaceRepository>& repositories) {
+        std::set<std::string> known;
+        for (const WorkspaceRepository& repository : repositories) {
+            known.insert(repository.path);
+        }
+        for (auto it = entries.begin(); it != entries.end();) {
+            it = known.count(it->first) ? std::next(it) : entries.erase(it);
+        }
+    }
+
+private:
+    std::map<std::string, DashboardEntry> entries;
+};
+
+// Кэш списка веток удаленных репозиториев (результат git ls-remote) по URL.
+// Записи живут несколько секунд: этого достаточно, чтобы проверка перед отправкой
+// и сама отправка не обращались к серверу дважды. Доступ из фоновых задач защищен мьютексом
+class RemoteRefCache {
+public:
+    // Ветки (имя -> SHA) или false, если записи нет или она устарела
+    bool find(const std::string& url, long long ttlSeconds, std::map<std::string, std::string>& heads) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(url);
+        if (it == entries.end() ||
+            std::chrono::steady_clock::now() - it->second.fetchedAt > std::chrono::seconds(ttlSeconds)) {
+            return false;
+        }
+        heads = it->second.heads;
+        return true;
+    }
+
+    void store(const std::string& url, std::map<std::string, std::string> heads) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries[url] = {std::move(heads), std::chrono::steady_clock::now()};
+    }
+
+    // Обновление веток после успешной отправки (пустой SHA - ветка удалена)
+    void update(const std::string& url, const std::map<std::string, std::string>& pushed) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(url);
+        if (it == entries.end()) {
+            return;
+        }
+        for (const auto& head : pushed) {
+            if (head.second.empty()) {
+                it->second.heads.erase(head.first);
+            } else {
+                it->second.heads[head.first] = head.second;
+            }
+        }
+    }
+
+    void invalidate(const std::string& url) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.erase(url);
+    }
+
+private:
+    struct Entry {
+        std::map<std::string, std::string> heads;
+        std::chrono::steady_clock::time_point fetchedAt;
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, Entry> entries;
+};
+
+// Граф шагов с зависимостями: готовые независимые шаги выполняются параллельно.
+// Выполненные шаги записываются в журнал; при ошибке rollback() отменяет их в обратном порядке
+class TaskGraph {
+public:
+    enum class State { Pending, Running, Done, Failed, Skipped };
+
+    // run и undo возвращают false при ошибке и могут записать пояснение в message
+    using Action = std::function<bool(std::string& message)>;
+
+    struct Step {
+        std::string id;
+        std::wstring title;
+        std::vector<std::string> dependencies;
+        Action run;
+        Action undo;
+        bool foreground = false;   // Выполняется в вызывающем потоке (например, может запросить ввод)
+        State state = State::Pending;
+        double seconds = 0;
+        std::string message;
+    };
+
+    // Вызывается при начале и завершении шага; вызовы не пересекаются между собой
+    using Callback = std::function<void(const Step&)>;
+
+    void add(const std::string& id, const std::wstring& title, std::vector<std::string> dependencies,
+             Action run, Action undo = nullptr, bool foreground = false) {
+        Step step;
+        step.id = id;
+        step.title = title;
+        step.dependencies = std::move(dependencies);
+        step.run = std::move(run);
+        step.undo = std::move(undo);
+        step.foreground = foreground;
+        steps.push_back(std::move(step));
+    }
+
+    // Выполнение графа: не более concurrency шагов одновременно. После ошибки новые шаги
+    // не запускаются, уже начатые завершаются. Возвращает true, если выполнены все шаги
+    bool run(int concurrency, const Callback& onChange) {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::vector<std::thread> threads;
+        bool failed = false;
+        int running = 0;
+
+        while (true) {
+            Step* foregroundStep = nullptr;
+            if (!failed) {
+                for (Step& step : steps) {
+                    if (step.state != State::Pending || !isReady(step)) {
+                        continue;
+                    }
+                    if (step.foreground) {
+                        foregroundStep = foregroundStep != nullptr ? foregroundStep : &step;
+                    } else if (running < std::max(1, concurrency)) {
+                        step.state = State::Running;
+                        running++;
+                        threads.emplace_back([this, &step, &onChange, &failed, &running]() {
+                            bool ok = execute(step, onChange);
+                            std::lock_guard<std::mutex> guard(mutex);
+                            finish(step, ok, failed, running, onChange);
+                        });
+                    }
+                }
+            }
+
+            if (foregroundStep != nullptr) {
+                foregroundStep->state = State::Running;
+                running++;
+                lock.unlock();
+                bool ok = execute(*foregroundStep, onChange);
+                lock.lock();
+                finish(*foregroundStep, ok, failed, running, onChange);
+                continue;
+            }
+            if (running == 0) {
+                break; // Все шаги выполнены либо оставшиеся заблокированы ошибкой
+            }
+            stepFinished.wait(lock);
+        }
+        lock.unlock();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (Step& step : steps) {
+            if (step.state == State::Pending) {
+                step.state = State::Skipped;
+            }
+        }
+        return !failed;
+    }
+
+    // Отмена выполненных шагов в порядке, обратном завершению; false - часть шагов отменить не удалось
+    bool rollback(const Callback& onUndo) {
+        bool undone = true;
+        for (auto it = journal.rbegin(); it != journal.rend(); ++it) {
+            Step& step = steps[*it];
+            if (!step.undo) {
+                continue;
+            }
+            step.message.clear();
+            if (!step.undo(step.message)) {
+                undone = false;
+                if (step.message.empty()) {
+                    step.message = "не удалось отменить";
+                }
+            }
+            onUndo(step);
+        }
+        journal.clear();
+        return undone;
+    }
+
+    const std::vector<Step>& getSteps() const {
+        return steps;
+    }
+
+private:
+    std::vector<Step> steps;
+    std::vector<size_t> journal;   // Номера выполненных шагов в порядке завершения
+    std::mutex mutex;
+    std::mutex callbackMutex;
+    std::condition_variable stepFinished;
+
+    bool isReady(const Step& step) const {
+        return std::all_of(step.dependencies.begin(), step.dependencies.end(), [this](const std::string& id) {
+            return std::any_of(steps.begin(), steps.end(), [&id](const Step& other) {
+                return other.id == id && other.state == State::Done;
+            });
+        });
+    }
+
+    bool execute(Step& step, const Callback& onChange) {
+        {
+            std::lock_guard<std::mutex> guard(callbackMutex);
+            onChange(step);
+        }
+        auto started = std::chrono::steady_clock::now();
+        bool ok = false;
+        try {
+            ok = step.run(step.message);
+        } catch (const std::exception& e) {
+            step.message = e.what();
+        }
+        step.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return ok;
+    }
+
+    // Вызывается под блокировкой mutex
+    void finish(Step& step, bool ok, bool& failed, int& running, const Callback& onChange) {
+        step.state = ok ? State::Done : State::Failed;
+        if (ok) {
+            journal.push_back(static_cast<size_t>(&step - &steps[0]));
+        } else {
+            failed = true;
+        }
+        running--;
+        {
+            std::lock_guard<std::mutex> guard(callbackMutex);
+            onChange(step);
+        }
+        stepFinished.notify_all();
+    }
+};
+
+// Признак отмены, разделяемый между инициатором и выполняемой операцией
+class CancellationToken {
+public:
+    CancellationToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const {
+        *flag = true;
+    }
+
+    bool isCancelled() const {
+        return *flag;
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+};
+
+// Обработка Ctrl-C: прерывается только команда, выполняемая на переднем плане, а не программа
+class ConsoleInterrupt {
+public:
+    static void install() {
+        mainThread() = std::this_thread::get_id();
+        SetConsoleCtrlHandler(handler, TRUE);
+    }
+
+    static bool isMainThread() {
+        return std::this_thread::get_id() == mainThread();
+    }
+
+    // Новый токен для очередной команды переднего плана
+    static CancellationToken beginForeground() {
+        std::lock_guard<std::mutex> lock(mutex());
+        current() = CancellationToken();
+        return current();
+    }
+
+private:
+    static BOOL WINAPI handler(DWORD type) {
+        if (type != CTRL_C_EVENT && type != CTRL_BREAK_EVENT) {
+            return FALSE;
+        }
+        std::lock_guard<std::mutex> lock(mutex());
+        current().cancel();
+        return TRUE;
+    }
+
+    static std::thread::id& mainThread() {
+        static std::thread::id id;
+        return id;
+    }
+
+    static std::mutex& mutex() {
+        static std::mutex instance;
+        return instance;
+    }
+
+    static CancellationToken& current() {
+        static CancellationToken token;
+        return token;
+    }
+};
+
+// Параметры запуска дочернего процесса
+struct ProcessOptions {
+    std::string workDir;        // Пусто - текущая директория
+    unsigned timeoutMs = 0;     // 0 - без ограничения
+    CancellationToken cancel;
+    bool background = false;    // Отдельная группа процессов (без Ctrl-C), ввод из NUL, без запросов git
+};
+
+// Запуск команды через cmd.exe с чтением stdout. Процесс помещается в объект задания Windows,
+// поэтому при отмене или истечении срока завершается все дерево процессов, а не только cmd.exe
+class ChildProcess {
+public:
+    static const int ExitFailedToStart = -1;
+    static const int ExitCancelled = -2;
+    static const int ExitTimedOut = -3;
+
+    // onOutput получает вывод по мере поступления; false - прекратить выполнение.
+    // Возвращает код завершения процесса или одну из констант Exit*
+    static int run(const std::string& command, const ProcessOptions& options,
+                   const std::function<bool(const char*, size_t)>& onOutput) {
+        SECURITY_ATTRIBUTES security = {};
+        security.nLength = sizeof(security);
+        security.bInheritHandle = TRUE;
+
+        // Наследуемые дескрипторы создаются и закрываются под блокировкой: иначе процесс,
+        // одновременно запущенный из другого потока, унаследует чужой канал и задержит его закрытие
+        std::unique_lock<std::mutex> spawnLock(spawnMutex());
+        HANDLE readPipe = nullptr;
+        HANDLE writePipe = nullptr;
+        if (!CreatePipe(&readPipe, &writePipe, &security, 0)) {
+            return ExitFailedToStart;
+        }
+        SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+
+        STARTUPINFOW startup = {};
+        startup.cb = sizeof(startup);
+        startup.dwFlags = STARTF_USESTDHANDLES;
+        startup.hStdOutput = writePipe;
+        HANDLE nullDevice = INVALID_HANDLE_VALUE;
+        if (options.background) {
+            nullDevice = CreateFileW(L"NUL", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                     &security, OPEN_EXISTING, 0, nullptr);
+            startup.hStdInput = nullDevice;
+            startup.hStdError = nullDevice;
+        } else {
+            startup.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+            startup.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+        }
+
+        std::wstring commandLine = L"cmd.exe /d /s /c \"" + toWide(command) + L"\"";
+        std::wstring directory = toWide(options.workDir);
+        std::wstring environment = options.background ? buildBackgroundEnvironment() : L"";
+        DWORD flags = CREATE_SUSPENDED | CREATE_UNICODE_ENVIRONMENT |
+                      (options.background ? CREATE_NEW_PROCESS_GROUP : 0);
+
+        PROCESS_INFORMATION process = {};
+        BOOL created = CreateProcessW(nullptr, &commandLine[0], nullptr, nullptr, TRUE, flags,
+                                      environment.empty() ? nullptr : &environment[0],
+                                      directory.empty() ? nullptr : directory.c_str(), &startup, &process);
+
+        // Копии дескрипторов остались у дочернего процесса; без закрытия записи чтение не увидит конец потока
+        CloseHandle(writePipe);
+        if (nullDevice != INVALID_HANDLE_VALUE) {
+            CloseHandle(nullDevice);
+        }
+        spawnLock.unlock();
+        if (!created) {
+            CloseHandle(readPipe);
+            return ExitFailedToStart;
+        }
+
+        // Процесс запускается приостановленным, чтобы попасть в задание до создания потомков
+        HANDLE job = CreateJobObjectW(nullptr, nullptr);
+        if (job != nullptr && !AssignProcessToJobObject(job, process.hProcess)) {
+            CloseHandle(job);
+            job = nullptr;
+        }
+        ResumeThread(process.hThread);
+        CloseHandle(process.hThread);
+
+        auto started = std::chrono::steady_clock::now();
+        int outcome = 0;
+        bool pipeOpen = true;
+        bool exited = false;
+        char buffer[4096];
+        while (true) {
+            DWORD available = 0;
+            if (pipeOpen && !PeekNamedPipe(readPipe, nullptr, 0, nullptr, &available, nullptr)) {
+                pipeOpen = false; // Все владельцы канала закрыли запись
+            }
+            if (available > 0) {
+                DWORD bytesRead = 0;
+                if (ReadFile(readPipe, buffer, std::min<DWORD>(available, sizeof(buffer)), &bytesRead, nullptr) &&
+                    bytesRead > 0 && !onOutput(buffer, bytesRead)) {
+                    outcome = ExitCancelled;
+                    break;
+                }
+                continue;
+            }
+            if (exited) {
+                break; // Процесс завершился, непрочитанных данных нет
+            }
+            if (options.cancel.isCancelled()) {
+                outcome = ExitCancelled;
+                break;
+            }
+            if (options.timeoutMs > 0 && std::chrono::steady_clock::now() - started >=
+                std::chrono::milliseconds(options.timeoutMs)) {
+                outcome = ExitTimedOut;
+                break;
+            }
+            exited = WaitForSingleObject(process.hProcess, pipeOpen ? 10 : 50) == WAIT_OBJECT_0;
+        }
+
+        int exitCode = outcome;
+        if (outcome != 0) {
+            if (job != nullptr) {
+                TerminateJobObject(job, 1);
+            } else {
+                TerminateProcess(process.hProcess, 1);
+            }
+            WaitForSingleObject(process.hProcess, 5000);
+        } else {
+            DWORD code = 0;
+            GetExitCodeProcess(process.hProcess, &code);
+            exitCode = static_cast<int>(code);
+        }
+
+        if (job != nullptr) {
+            CloseHandle(job);
+        }
+        CloseHandle(process.hProcess);
+        CloseHandle(readPipe);
+        return exitCode;
+    }
+
+private:
+    static std::mutex& spawnMutex() {
+        static std::mutex instance;
+        return instance;
+    }
+
+    static std::wstring toWide(const std::string& str) {
+        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+        return converter.from_bytes(str);
+    }
+
+    // Окружение фонового процесса: git и менеджер учетных данных не должны ждать ввода
+    static std::wstring buildBackgroundEnvironment() {
+        const std::vector<std::wstring> overrides = {L"GIT_TERMINAL_PROMPT=0", L"GCM_INTERACTIVE=never"};
+        std::wstring block;
+        wchar_t* strings = GetEnvironmentStringsW();
+        for (const wchar_t* entry = strings; entry != nullptr && *entry != L'\0'; entry += wcslen(entry) + 1) {
+            std::wstring variable(entry);
+            bool overridden = std::any_of(overrides.begin(), overrides.end(), [&variable](const std::wstring& item) {
+                return variable.compare(0, item.find(L'=') + 1, item, 0, item.find(L'=') + 1) == 0;
+            });
+            if (!overridden) {
+                block += variable;
+                block += L'\0';
+            }
+        }
+        if (strings != nullptr) {
+            FreeEnvironmentStringsW(strings);
+        }
+        for (const auto& item : overrides) {
+            block += item;
+            block += L'\0';
+        }
+        block += L'\0';
+        return block;
+    }
+};
+
+// Фоновая предварительная загрузка (как git maintenance prefetch): удаленные репозитории
+// периодически загружаются в refs/prefetch/remotes/<remote>/*, не затрагивая refs/remotes.
+// Каждый репозиторий загружается со своим случайным смещением периода, одновременно
+// выполняется не больше concurrency загрузок; после ошибок период увеличивается
+class PrefetchScheduler {
+public:
+    struct Target {
+        std::string key;      // общая директория репозитория (у worktree одна на всех)
+        std::string workDir;
+        std::string url;      // адрес origin
+    };
+    using FetchFunction = std::function<bool(const Target&, const CancellationToken&)>;
+
+    explicit PrefetchScheduler(FetchFunction fetch) : fetch(std::move(fetch)), random(std::random_device{}()) {}
+
+    ~PrefetchScheduler() {
+        stop();
+    }
+
+    // Перезапуск с новыми параметрами; interval 0 останавливает загрузку
+    void configure(std::chrono::seconds newInterval, int newConcurrency) {
+        std::lock_guard<std::mutex> guard(configureMutex);
+        stop();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            interval = newInterval;
+            stopping = false;
+            cancel = CancellationToken();
+        }
+        if (interval.count() <= 0) {
+            return;
+        }
+        for (int i = 0; i < std::max(1, newConcurrency); i++) {
+            workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    // Новые репозитории получают случайную первую задержку в пределах периода,
+    // чтобы загрузки не начинались одновременно
+    void setTargets(const std::vector<Target>& targets) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = std::chrono::steady_clock::now();
+        std::map<std::string, State> updated;
+        for (const Target& target : targets) {
+            auto it = states.find(target.key);
+            if (it != states.end()) {
+                it->second.target = target;
+                updated.insert(*it);
+            } else {
+                State state;
+                state.target = target;
+                state.due = now + scale(interval, 0.0, 1.0);
+                updated[target.key] = state;
+            }
+        }
+        states = std::move(updated);
+        ready.notify_all();
+    }
+
+    // Время завершения загрузки (секунды), которая еще не перенесена в refs/remotes; 0 - нет такой
+    long long takePending(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = states.find(key);
+        if (it == states.end()) {
+            return 0;
+        }
+        long long fetchedAt = it->second.pendingSince;
+        it->second.pendingSince = 0;
+        return fetchedAt;
+    }
+
+private:
+    struct State {
+        Target target;
+        std::chrono::steady_clock::time_point due;
+        bool running = false;
+        int failures = 0;
+        long long pendingSince = 0;
+    };
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            cancel.cancel();
+        }
+        ready.notify_all();
+        for (auto& thread : workers) {
+            thread.join();
+        }
+        workers.clear();
+    }
+
+    // Случайная доля периода из [from, to)
+    std::chrono::steady_clock::duration scale(std::chrono::seconds period, double from, double to) {
+        std::uniform_real_distribution<double> distribution(from, to);
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(period * distribution(random));
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            // Ближайший по сроку репозиторий, который сейчас не загружается
+            State* next = nullptr;
+            for (auto& item : states) {
+                if (!item.second.running && (next == nullptr || item.second.due < next->due)) {
+                    next = &item.second;
+                }
+            }
+            if (next == nullptr) {
+                ready.wait(lock);
+                continue;
+            }
+            if (next->due > std::chrono::steady_clock::now()) {
+                ready.wait_until(lock, next->due);
+                continue;
+            }
+
+            next->running = true;
+            Target target = next->target;
+            CancellationToken token = cancel;
+            lock.unlock();
+            bool ok = fetch(target, token);
+            lock.lock();
+
+            auto it = states.find(target.key);
+            if (it == states.end()) {
+                continue; // Репозиторий исключен из списка во время загрузки
+            }
+            State& state = it->second;
+            state.running = false;
+            state.failures = ok ? 0 : std::min(state.failures + 1, 4);
+            if (ok) {
+                state.pendingSince = static_cast<long long>(std::time(nullptr));
+            }
+            // Период с разбросом ±20%, после ошибок - в 2, 4, 8, 16 раз больше
+            state.due = std::chrono::steady_clock::now() + scale(interval * (1 << state.failures), 0.8, 1.2);
+            ready.notify_all();
+        }
+    }
+
+    FetchFunction fetch;
+    std::mt19937 random;
+    std::mutex configureMutex;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::map<std::string, State> states;
+    std::vector<std::thread> workers;
+    std::chrono::seconds interval{0};
+    CancellationToken cancel;
+    bool stopping = false;
+};
+
+// Фоновая задача: состояние, прогресс и журнал вывода
+class Job {
+public:
+    enum class State { Queued, Running, Succeeded, Failed, Cancelled };
+
+    // cancellation - общий признак отмены, если задача входит в группу, отменяемую целиком
+    Job(int id, std::wstring title, std::string repository, CancellationToken cancellation = CancellationToken())
+        : id(id), title(std::move(title)), repository(std::move(repository)),
+          cancellation(std::move(cancellation)), createdAt(std::chrono::steady_clock::now()) {}
+
+    const int id;
+    const std::wstring title;
+    const std::string repository;
+
+    State getState() const {
+        return state;
+    }
+
+    bool isFinished() const {
+        State current = state;
+        return current == State::Succeeded || current == State::Failed || current == State::Cancelled;
+    }
+
+    // Процент выполнения из вывода git ("Writing objects:  45%"), -1 - неизвестно
+    int getProgress() const {
+        return progress;
+    }
+
+    std::string getPhase() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return phase;
+    }
+
+    std::string getLog() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return log;
+    }
+
+    // Время выполнения (для задачи в очереди - 0)
+    double elapsedSeconds() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (state == State::Queued) {
+            return 0;
+        }
+        auto end = isFinished() ? finishedAt : std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - startedAt).count();
+    }
+
+    void requestCancel() {
+        cancellation.cancel();
+    }
+
+    bool isCancelRequested() const {
+        return cancellation.isCancelled();
+    }
+
+    const CancellationToken& getCancellation() const {
+        return cancellation;
+    }
+
+    // Вывод команды. Строки, завершенные '\r' (обновления прогресса git), в журнал не попадают
+    void appendOutput(const char* data, size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < size; i++) {
+            char c = data[i];
+            if (c == '\r' || c == '\n') {
+                parseProgress(currentLine);
+                if (c == '\n') {
+                    log += currentLine + "\n";
+                }
+                currentLine.clear();
+            } else {
+                currentLine += c;
+            }
+        }
+        if (log.size() > MaxLogSize) {
+            log.erase(0, log.size() - MaxLogSize);
+        }
+    }
+
+    void appendText(const std::string& text) {
+        appendOutput(text.data(), text.size());
+    }
+
+    void markStarted() {
+        std::lock_guard<std::mutex> lock(mutex);
+        startedAt = std::chrono::steady_clock::now();
+        state = State::Running;
+    }
+
+    void markFinished(State finalState) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!currentLine.empty()) {
+            log += currentLine + "\n";
+            currentLine.clear();
+        }
+        if (state == State::Queued) {
+            startedAt = std::chrono::steady_clock::now();
+        }
+        finishedAt = std::chrono::steady_clock::now();
+        if (finalState == State::Succeeded) {
+            progress = 100;
+        }
+        state = finalState;
+    }
+
+private:
+    static const size_t MaxLogSize = 64 * 1024;
+
+    std::atomic<State> state{State::Queued};
+    std::atomic<int> progress{-1};
+    CancellationToken cancellation;
+    std::chrono::steady_clock::time_point createdAt;
+    std::chrono::steady_clock::time_point startedAt;
+    std::chrono::steady_clock::time_point finishedAt;
+    std::string phase;
+    std::string log;
+    std::string currentLine;
+    mutable std::mutex mutex;
+
+    void parseProgress(const std::string& line) {
+        size_t percent = line.rfind('%');
+        if (percent == std::string::npos) {
+            return;
+        }
+        size_t start = percent;
+        while (start > 0 && std::isdigit(static_cast<unsigned char>(line[start - 1]))) {
+            start--;
+        }
+        if (start == percent || percent - start > 3) {
+            return;
+        }
+        progress = std::atoi(line.c_str() + start);
+
+        size_t colon = line.rfind(':', start);
+        if (colon != std::string::npos) {
+            size_t phaseStart = line.rfind("remote: ", colon) == 0 ? 8 : 0;
+            phase = line.substr(phaseStart, colon - phaseStart);
+        }
+    }
+};
+
+// Очередь фоновых задач с пулом рабочих потоков (потоки создаются при первой задаче)
+class JobManager {
+public:
+    using Work = std::function<bool(Job&)>;
+
+    explicit JobManager(size_t workerCount) : workerCount(std::max<size_t>(1, workerCount)) {}
+
+    ~JobManager() {
+        shutdown(true);
+    }
+
+    JobManager(const JobManager&) = delete;
+    JobManager& operator=(const JobManager&) = delete;
+
+    std::shared_ptr<Job> submit(const std::wstring& title, const std::string& repository, Work work) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto job = std::make_shared<Job>(nextId++, title, repository);
+        jobs.push_back(job);
+        queue.push_back({job, std::move(work)});
+        while (workers.size() < workerCount) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+        queueChanged.notify_one();
+        return job;
+    }
+
+    std::vector<std::shared_ptr<Job>> list() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return jobs;
+    }
+
+    std::shared_ptr<Job> find(int id) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& job : jobs) {
+            if (job->id == id) {
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    // Ожидание завершения задачи не дольше timeout; true - задача завершена
+    bool waitFor(const std::shared_ptr<Job>& job, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return jobFinished.wait_for(lock, timeout, [&job]() { return job->isFinished(); });
+    }
+
+    size_t activeCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::count_if(jobs.begin(), jobs.end(), [](const std::shared_ptr<Job>& job) {
+            return !job->isFinished();
+        });
+    }
+
+    // Завершенные задачи, о которых пользователь еще не уведомлен
+    std::vector<std::shared_ptr<Job>> takeFinished() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::shared_ptr<Job>> finished;
+        for (const auto& job : jobs) {
+            if (job->isFinished() && noticed.insert(job->id).second) {
+                finished.push_back(job);
+            }
+        }
+        return finished;
+    }
+
+    // Остановка пула: cancelAll - отменить незавершенные задачи, иначе дождаться их выполнения
+    void shutdown(bool cancelAll) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            if (cancelAll) {
+                for (const auto& job : jobs) {
+                    job->requestCancel();
+                }
+            }
+            queueChanged.notify_all();
+        }
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        workers.clear();
+    }
+
+private:
+    struct QueuedJob {
+        std::shared_ptr<Job> job;
+        Work work;
+    };
+
+    size_t workerCount;
+    int nextId = 1;
+    bool stopping = false;
+    std::vector<std::shared_ptr<Job>> jobs;
+    std::deque<QueuedJob> queue;
+    std::set<int> noticed;
+    std::vector<std::thread> workers;
+    mutable std::mutex mutex;
+    std::condition_variable queueChanged;
+    std::condition_variable jobFinished;
+
+    void workerLoop() {
+        while (true) {
+            QueuedJob item;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                queueChanged.wait(lock, [this]() { return stopping || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                item = std::move(queue.front());
+                queue.pop_front();
+            }
+
+            Job& job = *item.job;
+            if (job.isCancelRequested()) {
+                job.markFinished(Job::State::Cancelled);
+            } else {
+                job.markStarted();
+                bool succeeded = false;
+                try {
+                    succeeded = item.work(job);
+                } catch (const std::exception& e) {
+                    job.appendText(std::string("Ошибка: ") + e.what() + "\n");
+                }
+                job.markFinished(job.isCancelRequested() ? Job::State::Cancelled :
+                                 succeeded ? Job::State::Succeeded : Job::State::Failed);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            jobFinished.notify_all();
+        }
+    }
+};
+
+// Класс для управления GitHub репозиториями
+class GitHubManager {
+private:
+    std::wstring username;
+    std::wstring email;
+    bool isAuthenticated = false;
+    std::wstring currentDirectory; // Текущая рабочая директория
+
+    // Кэш индексов веток по репозиториям
+    struct CachedRefIndex {
+        RefIndex index;
+        std::filesystem::file_time_type fingerprint;
+    };
+    std::map<std::string, CachedRefIndex> refIndexCache;
+    
+    // Ветки удаленных репозиториев по URL (remote_refs_ttl секунд)
+    RemoteRefCache remoteRefCache;
+
+    // Клиент GitHub REST API (создается при первом обращении)
+    std::unique_ptr<GitHubApiClient> apiClient;
+
+    // Статистика последней постраничной загрузки
+    int pagesFromCache = 0;
+    int pagesFetched = 0;
+
+    // Сохраненный сеанс: данные пользователя с последней проверки токена
+    struct SessionInfo {
+        std::string login;
+        std::string email;
+        std::string scopes;       // Значение X-OAuth-Scopes (через запятую)
+        std::string tokenHash;    // Отпечаток токена; сам токен не сохраняется
+        std::string baseUrl;
+        long long validatedAt = 0;
+        long long expiresAt = 0;
+    };
+
+    // Результат фоновой проверки сохраненного сеанса
+    struct SessionCheck {
+        bool valid = false;
+        SessionInfo info;
+        std::string token;
+        std::string error;
+    };
+
+    std::string tokenScopes;
+    std::future<SessionCheck> sessionCheck;
+
+    // Предельное время выполнения команды (с), 0 - без ограничения
+    std::atomic<int> commandTimeoutSeconds{0};
+
+    // Фоновые задачи (пул создается при первой задаче)
+    std::unique_ptr<JobManager> jobManager;
+
+    // Локальный индекс репозиториев (обновляется при первом поиске за сеанс)
+    RepositoryIndex repositoryIndex;
+    bool repositoryIndexRefreshed = false;
+
+    // Шаблоны .gitignore (загружаются с диска при первом обращении) и разобранные шаблоны README
+    TemplateStore gitignoreStore;
+    bool gitignoreStoreLoaded = false;
+    std::map<std::string, std::shared_ptr<const TextTemplate>> readmeTemplateCache;
+
+    // Зеркала для клонирования (создается при первом клонировании)
+    std::unique_ptr<MirrorCache> mirrorCache;
+    std::string gitProtocol;
+
+    // Индекс репозиториев рабочего пространства (загружается при первом обращении)
+    WorkspaceIndex workspaceIndex;
+    bool workspaceIndexLoaded = false;
+    std::chrono::steady_clock::time_point workspaceRefreshedAt;
+    DashboardCache dashboardCache;
+    bool dashboardCacheLoaded = false;
+
+    // Фоновая предварительная загрузка удаленных репозиториев (prefetch_interval)
+    std::unique_ptr<PrefetchScheduler> prefetchScheduler;
+    std::string prefetchTargetsState; // Текущая директория и время обновления индекса для списка загрузки
+
+    // Результат выполнения команды
+    struct CommandResult {
+        int exitCode = -1;
+        std::string output;
+
+        bool succeeded() const {
+            return exitCode == 0;
+        }
+    };
+
+    // Параметры ускорения git status (определяются один раз за запуск)
+    std::string statusAccelerationArgs;
+    bool statusAccelerationProbed = false;
+
+    // Настройки приложения (ключ -> значение), хранятся в settings.ini
+    std::map<std::string, std::string> settings;
+
+    // Описание настройки для меню настроек
+    struct SettingInfo {
+        std::string key;
+        std::wstring description;
+        std::string defaultValue;
+    };
+
+    // Рабочая копия из пула git worktree
+    struct WorktreeEntry {
+        std::string branch;
+        std::string path;
+        long long lastUsed = 0;
+    };
+
+    // Выполнение команды в командной строке
+    std::string executeCommand(const std::string& command) {
+        return executeCommandInDirectory(command, "");
+    }
+
+    // Выполнение команды в указанной директории
+    std::string executeCommandInDirectory(const std::string& command, const std::string& directory) {
+        std::string result;
+        int exitCode = executeCommandStreaming(command, directory, [&result](const char* data, size_t size) {
+            result.append(data, size);
+            return true;
+        });
+        
+        if (exitCode == ChildProcess::ExitFailedToStart) {
+            return "Ошибка выполнения команды.";
+        }
+
+        // Перевод строк как при чтении в текстовом режиме
+        result.erase(std::remove(result.begin(), result.end(), '\r'), result.end());
+        return result;
+    }
+
+    // Конвертация из string в wstring
+    std::wstring stringToWstring(const std::string& str) {
+        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+        return converter.from_bytes(str);
+    }
+
+    // Конвертация из wstring в string
+    std::string wstringToString(const std::wstring& wstr) {
+        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+        return converter.to_bytes(wstr);
+    }
+
+    // Проверка, находимся ли мы в директории Git репозитория
+    bool isGitRepository() {
+        CommandResult result = runCommand("git rev-parse --is-inside-work-tree 2>nul", "", false);
+        return result.succeeded() && trimString(result.output) == "true";
+    }
+
+    // Проверка, является ли указанная директория Git репозиторием
+    bool isGitRepository(const std::string& directory) {
+        CommandResult result = runCommand("git rev-parse --is-inside-work-tree 2>nul", directory, false);
+        return result.succeeded() && trimString(result.output) == "true";
+    }
+
+    // Проверка, хочет ли пользователь вернуться в главное меню
+    bool checkForHomeCommand(const std::wstring& input) {
+        std::wstring lowerInput = input;
+        std::transform(lowerInput.begin(), lowerInput.end(), lowerInput.begin(), ::tolower);
+        return (lowerInput == L"home" || lowerInput == L"домой" || lowerInput == L"меню" || lowerInput == L"выход");
+    }
+
+    // Создание первого коммита в репозитории
+    bool createInitialCommit(const std::string& workDir = "") {
+        std::wcout << L"В репозитории пока нет коммитов. Необходимо сделать первый коммит.\n";
+        std::wcout << L"Хотите создать первый коммит? (д/н): ";
+        wchar_t choice;
+        std::wcin >> choice;
+        std::wcin.ignore();
+        
+        if (choice == L'д' || choice == L'Д') {
+            // Создаем пустой README.md для первого коммита
+            std::string createReadmeCmd = "echo # New Repository > README.md";
+            std::string addCmd = "git add README.md";
+            std::string commitCmd = "git commit -m \"Initial commit\"";
+            
+            if (workDir.empty()) {
+                executeCommand(createReadmeCmd);
+                executeCommand(addCmd);
+                std::string result = executeCommand(commitCmd);
+                std::wcout << stringToWstring(result) << L"\n";
+            } else {
+                executeCommandInDirectory(createReadmeCmd, workDir);
+                executeCommandInDirectory(addCmd, workDir);
+                std::string result = executeCommandInDirectory(commitCmd, workDir);
+                std::wcout << stringToWstring(result) << L"\n";
+            }
+            
+            std::wcout << L"Первый коммит создан. Теперь можно работать с ветками.\n";
+            return true;
+        } else {
+            std::wcout << L"Операция отменена. Создайте первый коммит для работы с ветками.\n";
+            return false;
+        }
+    }
+
+    // Проверка наличия коммитов в репозитории
+    bool hasCommits(const std::string& workDir = "") {
+        return runCommand("git rev-parse --verify --quiet HEAD", workDir, false).succeeded();
+    }
+
+    // Выполнение команды в рабочей директории (пустая строка - текущая директория)
+    std::string executeCommandInWorkDir(const std::string& command, const std::string& workDir) {
+        if (workDir.empty()) {
+            return executeCommand(command);
+        }
+        return executeCommandInDirectory(command, workDir);
+    }
+
+    // Потоковое выполнение команды: вывод передается обработчику частями по мере поступления,
+    // обработчик может прекратить выполнение, вернув false. Команда ограничена сроком
+    // command_timeout и прерывается по токену cancel; без токена команда из потока меню
+    // прерывается по Ctrl-C, а команда из фонового потока запускается в отдельной группе процессов.
+    // Возвращает код завершения команды или ChildProcess::Exit*
+    int executeCommandStreaming(const std::string& command, const std::string& workDir,
+                                const std::function<bool(const char*, size_t)>& onChunk,
+                                const CancellationToken* cancel = nullptr) {
+        ProcessOptions options;
+        options.workDir = workDir;
+        options.timeoutMs = static_cast<unsigned>(std::max(0, commandTimeoutSeconds.load())) * 1000u;
+        bool foreground = ConsoleInterrupt::isMainThread();
+        options.background = !foreground;
+        options.cancel = cancel != nullptr ? *cancel :
+                         foreground ? ConsoleInterrupt::beginForeground() : CancellationToken();
+
+        int exitCode = ChildProcess::run(command, options, onChunk);
+
+        if (foreground && exitCode == ChildProcess::ExitTimedOut) {
+            std::wcout << L"\nКоманда прервана: превышено время ожидания (" << commandTimeoutSeconds << L" с).\n";
+        } else if (foreground && exitCode == ChildProcess::ExitCancelled && options.cancel.isCancelled()) {
+            std::wcout << L"\nКоманда прервана.\n";
+        }
+        return exitCode;
+    }
+
+    // Выполнение команды с кодом завершения. Успех определяется только кодом завершения.
+    // По умолчанию вывод ошибок объединяется с основным выводом для показа пользователю;
+    // для разбора структурированного вывода (JSON, -z) объединение нужно отключить
+    CommandResult runCommand(const std::string& command, const std::string& workDir = "", bool mergeStderr = true) {
+        CommandResult result;
+        result.exitCode = executeCommandStreaming(mergeStderr ? command + " 2>&1" : command, workDir,
+                                                  [&result](const char* data, size_t size) {
+            result.output.append(data, size);
+            return true;
+        });
+        return result;
+    }
+
+    // Проверка наличия удаленного репозитория с указанным именем
+    bool hasRemote(const std::string& remote, const std::string& workDir) {
+        return runCommand("git remote get-url " + remote, workDir, false).succeeded();
+    }
+
+    // Параметры git для ускорения проверки состояния: кэш неотслеживаемых файлов (git 2.8+)
+    // и, только при status_acceleration=fsmonitor, встроенный fsmonitor (git 2.37+) - он запускает
+    // фоновый процесс в каждом репозитории. Включенный в конфигурации репозитория fsmonitor git
+    // использует и без этого параметра. Версия git определяется один раз
+    const std::string& getStatusAccelerationArgs() {
+        if (statusAccelerationProbed) {
+            return statusAccelerationArgs;
+        }
+        statusAccelerationProbed = true;
+
+        if (getSetting("status_acceleration") == "off") {
+            return statusAccelerationArgs;
+        }
+
+        // Формат: "git version 2.45.1.windows.1"
+        int major = 0, minor = 0;
+        std::string version = executeCommand("git --version");
+        std::sscanf(version.c_str(), "git version %d.%d", &major, &minor);
+
+        if (major > 2 || (major == 2 && minor >= 8)) {
+            statusAccelerationArgs += " -c core.untrackedCache=true";
+        }
+        if ((major > 2 || (major == 2 && minor >= 37)) && getSetting("status_acceleration") == "fsmonitor") {
+            statusAccelerationArgs += " -c core.fsmonitor=true";
+        }
+        return statusAccelerationArgs;
+    }
+
+    // Полное структурированное состояние рабочей копии
+    WorkingTreeStatus getWorkingTreeStatus(const std::string& workDir) {
+        std::string output;
+        executeCommandStreaming("git" + getStatusAccelerationArgs() + " status --porcelain=v2 -z --branch",
+                                workDir, [&output](const char* data, size_t size) {
+            output.append(data, size);
+            return true;
+        });
+        return WorkingTreeStatus::parse(std::move(output));
+    }
+
+    // Быстрая проверка наличия изменений. Каждый этап завершается на первом найденном изменении:
+    // git diff --quiet прекращает сравнение на первом отличии, а чтение списка
+    // неотслеживаемых файлов прерывается на первом байте
+    bool isWorkingTreeDirty(const std::string& workDir) {
+        if (!hasCommits(workDir)) {
+            return !getWorkingTreeStatus(workDir).isClean();
+        }
+
+        const std::string& acceleration = getStatusAccelerationArgs();
+        std::string cmd = "git" + acceleration + " diff --quiet --cached HEAD -- && "
+                          "git" + acceleration + " diff --quiet -- && "
+                          "git" + acceleration + " ls-files -z --others --exclude-standard --directory --no-empty-directory";
+
+        bool foundUntracked = false;
+        int exitCode = executeCommandStreaming(cmd, workDir, [&foundUntracked](const char*, size_t) {
+            foundUntracked = true;
+            return false;
+        });
+
+        return foundUntracked || exitCode != 0;
+    }
+
+    // Краткая сводка состояния рабочей копии
+    void printStatusSummary(const WorkingTreeStatus& status, size_t maxPaths = 20) {
+        std::wcout << L"Проиндексировано: " << status.staged
+                  << L", изменено: " << status.unstaged
+                  << L", неотслеживаемых: " << status.untracked;
+        if (status.conflicted > 0) {
+            std::wcout << L", конфликтов: " << status.conflicted;
+        }
+        std::wcout << L"\n";
+
+        for (size_t i = 0; i < status.entries.size() && i < maxPaths; i++) {
+            const StatusEntry& entry = status.entries[i];
+            std::wstring marker = entry.kind == '?' ? L"??" :
+                                  std::wstring(1, static_cast<wchar_t>(entry.indexStatus)) +
+                                  static_cast<wchar_t>(entry.worktreeStatus);
+            std::wcout << L"  " << marker << L" " << stringToWstring(std::string(entry.path));
+            if (!entry.originalPath.empty()) {
+                std::wcout << L" (из " << stringToWstring(std::string(entry.originalPath)) << L")";
+            }
+            std::wcout << L"\n";
+        }
+
+        if (status.entries.size() > maxPaths) {
+            std::wcout << L"  ... и еще " << (status.entries.size() - maxPaths) << L"\n";
+        }
+    }
+
+    // Удаление пробелов и символов перевода строки по краям
+    static std::string trimString(const std::string& str) {
+        size_t start = str.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos) {
+            return "";
+        }
+        size_t end = str.find_last_not_of(" \t\r\n");
+        return str.substr(start, end - start + 1);
+    }
+
+    // Сопоставление имени ветки с шаблоном ('*' - любые символы кроме '/', '**' - любые, '?' - один символ)
+    static bool matchesGlob(const std::string& name, const std::string& pattern) {
+        size_t n = 0, p = 0;
+        size_t starPos = std::string::npos, starMatch = 0;
+        bool starCrossesSlash = false;
+
+        while (n < name.size()) {
+            if (p < pattern.size() && pattern[p] == '*') {
+                starCrossesSlash = (p + 1 < pattern.size() && pattern[p + 1] == '*');
+                p += starCrossesSlash ? 2 : 1;
+                starPos = p;
+                starMatch = n;
+            } else if (p < pattern.size() && (pattern[p] == name[n] || (pattern[p] == '?' && name[n] != '/'))) {
+                p++;
+                n++;
+            } else if (starPos != std::string::npos && (starCrossesSlash || name[starMatch] != '/')) {
+                // Расширяем последнюю звездочку на один символ
+                starMatch++;
+                n = starMatch;
+                p = starPos;
+            } else {
+                return false;
+            }
+        }
+
+        while (p < pattern.size() && pattern[p] == '*') {
+            p++;
+        }
+        return p == pattern.size();
+    }
+
+    // Получение локальных веток и их коммитов (имя -> SHA)
+    std::map<std::string, std::string> getLocalBranchHeads(const std::string& workDir) {
+        std::map<std::string, std::string> heads;
+        std::string output = executeCommandInWorkDir(
+            "git for-each-ref --format=\"%(refname:short)|%(objectname)\" refs/heads", workDir);
+
+        std::istringstream stream(output);
+        std::string line;
+        while (std::getline(stream, line)) {
+            line = trimString(line);
+            size_t sep = line.find('|');
+            if (sep == std::string::npos) {
+                continue;
+            }
+            heads[line.substr(0, sep)] = line.substr(sep + 1);
+        }
+        return heads;
+    }
+
+    // URL удаленного репозитория (пустая строка, если remote не настроен)
+    std::string getRemoteUrl(const std::string& remote, const std::string& workDir) {
+        CommandResult result = runCommand("git remote get-url " + remote, workDir, false);
+        return result.succeeded() ? trimString(result.output) : "";
+    }
+
+    // Получение веток удаленного репозитория одним запросом (имя -> SHA). Ответ сервера
+    // кэшируется на remote_refs_ttl секунд; reachable = false, если сервер не ответил
+    std::map<std::string, std::string> getRemoteBranchHeads(const std::string& remote, const std::string& workDir,
+                                                             bool* reachable = nullptr) {
+        std::map<std::string, std::string> heads;
+        std::string url = getRemoteUrl(remote, workDir);
+        long long ttl = std::max(0, getIntSetting("remote_refs_ttl", 30));
+        if (!url.empty() && remoteRefCache.find(url, ttl, heads)) {
+            if (reachable != nullptr) {
+                *reachable = true;
+            }
+            return heads;
+        }
+
+        CommandResult result = runCommand("git " + gitCredentialOptions(url) + "ls-remote --heads " + remote, workDir);
+        if (reachable != nullptr) {
+            *reachable = result.succeeded();
+        }
+
+        std::istringstream stream(result.output);
+        std::string line;
+        const std::string prefix = "refs/heads/";
+        while (std::getline(stream, line)) {
+            line = trimString(line);
+            size_t tab = line.find('\t');
+            if (tab == std::string::npos || line.compare(tab + 1, prefix.size(), prefix) != 0) {
+                continue;
+            }
+            heads[line.substr(tab + 1 + prefix.size())] = line.substr(0, tab);
+        }
+        if (result.succeeded() && !url.empty()) {
+            remoteRefCache.store(url, heads);
+        }
+        return heads;
+    }
+
+    // Состояние ветки перед отправкой: локальный SHA и SHA ветки на удаленном репозитории
+    struct PushCheck {
+        std::string url;
+        std::string localSha;
+        std::string remoteSha;
+        bool reachable = false;
+
+        bool upToDate() const {
+            return reachable && !localSha.empty() && localSha == remoteSha;
+        }
+    };
+
+    PushCheck checkBranchPush(const std::string& remote, const std::string& localBranch,
+                              const std::string& remoteBranch, const std::string& workDir) {
+        PushCheck check;
+        check.localSha = trimString(executeCommandInWorkDir(
+            "git rev-parse --verify --quiet refs/heads/" + localBranch, workDir));
+        if (check.localSha.empty()) {
+            return check; // Это не имя локальной ветки - проверку выполнит git push
+        }
+        check.url = getRemoteUrl(remote, workDir);
+        std::map<std::string, std::string> heads = getRemoteBranchHeads(remote, workDir, &check.reachable);
+        auto it = heads.find(remoteBranch);
+        if (it != heads.end()) {
+            check.remoteSha = it->second;
+        }
+        return check;
+    }
+
+    // Учет результата отправки в кэше веток (вызывается и из фоновых задач). SHA отправленной
+    // ветки определяется после push: пока задача ждала в очереди, в ветку могли добавиться коммиты
+    void recordPush(const PushCheck& check, const std::string& localBranch, const std::string& remoteBranch,
+                    bool succeeded, const std::string& workDir) {
+        if (check.url.empty()) {
+            return;
+        }
+        std::string localSha = succeeded ? trimString(executeCommandInWorkDir(
+            "git rev-parse --verify --quiet refs/heads/" + localBranch, workDir)) : "";
+        if (!localSha.empty()) {
+            remoteRefCache.update(check.url, {{remoteBranch, localSha}});
+        } else {
+            remoteRefCache.invalidate(check.url);
+        }
+    }
+
+    // Настройка upstream без отправки - то же, что делает push -u, когда ветка уже на сервере
+    void setBranchUpstream(const std::string& branch, const std::string& remote, const std::string& workDir) {
+        if (!trimString(executeCommandInWorkDir("git config branch." + branch + ".merge", workDir)).empty()) {
+            return;
+        }
+        runCommand("git config branch." + branch + ".remote " + remote, workDir);
+        runCommand("git config branch." + branch + ".merge refs/heads/" + branch, workDir);
+    }
+
+    // Проверка, есть ли в локальной ветке коммиты, которых нет на удаленном репозитории
+    bool hasUnpushedCommits(const std::string& localSha, const std::string& remoteSha, const std::string& workDir) {
+        if (remoteSha.empty()) {
+            return true; // Ветки нет на удаленном репозитории
+        }
+        if (localSha == remoteSha) {
+            return false;
+        }
+
+        std::string count = trimString(executeCommandInWorkDir(
+            "git rev-list --count " + remoteSha + ".." + localSha + " 2>nul", workDir));
+
+        // Коммит удаленной ветки не получен локально - считаем, что ветки различаются
+        if (count.empty()) {
+            return true;
+        }
+        return count != "0";
+    }
+
+    // Поиск служебной директории .git без запуска git (пустой путь, если не найдена)
+    std::filesystem::path findGitDirectory(const std::string& workDir) {
+        std::error_code ec;
+        std::filesystem::path dir = workDir.empty() ? std::filesystem::current_path(ec) : std::filesystem::path(workDir);
+
+        while (!dir.empty()) {
+            std::filesystem::path dotGit = dir / ".git";
+            if (std::filesystem::is_directory(dotGit, ec)) {
+                return dotGit;
+            }
+
+            // В рабочих копиях worktree и в подмодулях .git - это файл со ссылкой "gitdir: <путь>"
+            if (std::filesystem::is_regular_file(dotGit, ec)) {
+                std::ifstream file(dotGit);
+                std::string line;
+                std::getline(file, line);
+                const std::string prefix = "gitdir: ";
+                if (line.compare(0, prefix.size(), prefix) == 0) {
+                    std::filesystem::path gitDir = trimString(line.substr(prefix.size()));
+                    return gitDir.is_absolute() ? gitDir : dir / gitDir;
+                }
+                return {};
+            }
+
+            if (dir == dir.parent_path()) {
+                break;
+            }
+            dir = dir.parent_path();
+        }
+
+        return {};
+    }
+
+    // Общая директория репозитория, где хранятся ссылки (для worktree отличается от собственной)
+    std::filesystem::path findGitCommonDirectory(const std::string& workDir) {
+        std::filesystem::path gitDir = findGitDirectory(workDir);
+        if (gitDir.empty()) {
+            return gitDir;
+        }
+
+        std::ifstream commonDirFile(gitDir / "commondir");
+        std::string line;
+        if (commonDirFile && std::getline(commonDirFile, line)) {
+            std::filesystem::path commonDir = trimString(line);
+            return commonDir.is_absolute() ? commonDir : gitDir / commonDir;
+        }
+        return gitDir;
+    }
+
+    // Отпечаток состояния ссылок: меняется при создании, удалении и упаковке веток
+    std::filesystem::file_time_type getRefsFingerprint(const std::filesystem::path& commonDir) {
+        // Эпоха часов файловой системы зависит от библиотеки, время может быть отрицательным
+        std::filesystem::file_time_type fingerprint = std::filesystem::file_time_type::min();
+        std::error_code ec;
+        auto include = [&fingerprint](const std::filesystem::path& path) {
+            std::error_code timeError;
+            std::filesystem::file_time_type time = std::filesystem::last_write_time(path, timeError);
+            if (!timeError && time > fingerprint) {
+                fingerprint = time;
+            }
+        };
+        for (const char* entry : {"packed-refs", "refs/heads", "refs/remotes", "HEAD"}) {
+            include(commonDir / entry);
+        }
+        // Ветки вида feature/x лежат во вложенных директориях: их создание и удаление
+        // меняет время изменения только вложенной директории
+        for (const char* root : {"refs/heads", "refs/remotes"}) {
+            std::filesystem::recursive_directory_iterator it(commonDir / root, ec), end;
+            for (; !ec && it != end; it.increment(ec)) {
+                if (it->is_directory(ec)) {
+                    include(it->path());
+                }
+            }
+            ec.clear();
+        }
+        return fingerprint;
+    }
+
+    // Получение индекса веток; повторный запуск git нужен только при изменении ссылок
+    RefIndex& getRefIndex(const std::string& workDir) {
+        std::filesystem::path commonDir = findGitCommonDirectory(workDir);
+        std::filesystem::file_time_type fingerprint = getRefsFingerprint(commonDir);
+        std::string key = commonDir.empty() ? workDir : commonDir.string();
+
+        auto it = refIndexCache.find(key);
+        if (it != refIndexCache.end() && !commonDir.empty() && it->second.fingerprint == fingerprint) {
+            return it->second.index;
+        }
+
+        CachedRefIndex& cached = refIndexCache[key];
+        cached.index.load(executeCommandInWorkDir(
+            "git for-each-ref --format=\"%(committerdate:unix)|%(refname)\" refs/heads refs/remotes", workDir));
+        cached.fingerprint = fingerprint;
+        return cached.index;
+    }
+
+    // Сброс индекса веток после операций, которые изменяют ссылки
+    void invalidateRefIndex(const std::string& workDir) {
+        std::filesystem::path commonDir = findGitCommonDirectory(workDir);
+        refIndexCache.erase(commonDir.empty() ? workDir : commonDir.string());
+    }
+
+    // Число с заданным количеством знаков после запятой. Форматирование выполняется в отдельном
+    // потоке: флаги std::fixed и точность std::wcout не должны влиять на последующий вывод
+    static std::wstring formatFixed(double value, int precision = 1) {
+        std::wostringstream stream;
+        stream << std::fixed << std::setprecision(precision) << value;
+        return stream.str();
+    }
+
+    // Время в формате "N ед. назад"
+    static std::wstring formatAge(long long unixTime) {
+        long long seconds = static_cast<long long>(std::time(nullptr)) - unixTime;
+        if (unixTime <= 0 || seconds < 0) {
+            return L"";
+        }
+        if (seconds < 3600) {
+            return std::to_wstring(seconds / 60) + L" мин. назад";
+        }
+        if (seconds < 86400) {
+            return std::to_wstring(seconds / 3600) + L" ч. назад";
+        }
+        return std::to_wstring(seconds / 86400) + L" дн. назад";
+    }
+
+    // Интерактивный выбор ветки с нечетким поиском по мере ввода.
+    // Возвращает пустую строку при отмене; pickedRemote указывает, выбрана ли удаленная ветка
+    std::wstring pickBranch(const std::string& workDir, const std::wstring& title, bool includeRemote,
+                            bool* pickedRemote = nullptr) {
+        const size_t visibleCount = 10;
+        if (includeRemote && applyPrefetchedRefs(workDir)) {
+            invalidateRefIndex(workDir);
+        }
+        RefIndex& index = getRefIndex(workDir);
+
+        if (pickedRemote != nullptr) {
+            *pickedRemote = false;
+        }
+
+        // Начальный набор: все подходящие ветки, недавно обновленные первыми
+        std::vector<std::vector<RefIndex::Match>> history(1);
+        for (uint32_t i = 0; i < index.size(); i++) {
+            if (includeRemote || !index.isRemote(i)) {
+                history[0].push_back({i, 0});
+            }
+        }
+        std::sort(history[0].begin(), history[0].end(), [&index](const RefIndex::Match& a, const RefIndex::Match& b) {
+            return index.committedAt(a.index) > index.committedAt(b.index);
+        });
+
+        // Ввод не с консоли (перенаправлен) - показываем последние ветки и читаем строку
+        if (!_isatty(_fileno(stdin))) {
+            std::wcout << L"Недавние ветки:\n";
+            for (size_t i = 0; i < history[0].size() && i < visibleCount; i++) {
+                std::wcout << L"  " << stringToWstring(index.name(history[0][i].index)) << L"\n";
+            }
+            std::wcout << title << L" (или 'home' для возврата в меню): ";
+            std::wstring name;
+            std::getline(std::wcin, name);
+            return checkForHomeCommand(name) ? L"" : name;
+        }
+
+        std::wcout << title << L" (ввод - поиск, стрелки - выбор, Enter - подтвердить, Esc - отмена)\n";
+
+        std::wstring query;
+        size_t selected = 0;
+        size_t renderedLines = 0;
+
+        while (true) {
+            const std::vector<RefIndex::Match>& results = history.back();
+            if (selected >= results.size()) {
+                selected = results.empty() ? 0 : results.size() - 1;
+            }
+
+            // Перерисовываем только видимые строки поверх предыдущего вывода
+            if (renderedLines > 0) {
+                std::wcout << L"\x1b[" << renderedLines << L"F\x1b[J";
+            }
+
+            std::wcout << L"> " << query << L"  (" << results.size() << L" из " << history[0].size() << L")\n";
+            size_t shown = std::min(results.size(), visibleCount);
+            for (size_t i = 0; i < shown; i++) {
+                uint32_t ref = results[i].index;
+                std::wcout << (i == selected ? L" > " : L"   ") << stringToWstring(index.name(ref))
+                          << L"  " << formatAge(index.committedAt(ref)) << L"\n";
+            }
+            renderedLines = 1 + shown;
+            std::wcout.flush();
+
+            wint_t key = _getwch();
+
+            if (key == 27) { // Esc
+                std::wcout << L"Выбор отменен.\n";
+                return L"";
+            }
+
+            if (key == 13) { // Enter
+                if (!results.empty()) {
+                    uint32_t ref = results[selected].index;
+                    if (pickedRemote != nullptr) {
+                        *pickedRemote = index.isRemote(ref);
+                    }
+                    std::wstring name = stringToWstring(index.name(ref));
+                    std::wcout << L"Выбрана ветка: " << name << L"\n";
+                    return name;
+                }
+                if (!query.empty()) {
+                    return query; // Имя, которого нет в индексе, передаем как есть
+                }
+                continue;
+            }
+
+            if (key == 0 || key == 0xE0) { // Расширенные клавиши
+                wint_t extended = _getwch();
+                if (extended == 72 && selected > 0) { // Вверх
+                    selected--;
+                } else if (extended == 80 && selected + 1 < std::min(results.size(), visibleCount)) { // Вниз
+                    selected++;
+                }
+                continue;
+            }
+
+            if (key == 8) { // Backspace: возвращаемся к результатам более короткого запроса
+                if (!query.empty()) {
+                    query.pop_back();
+                    history.pop_back();
+                    selected = 0;
+                }
+                continue;
+            }
+
+            if (key >= 32) {
+                query.push_back(static_cast<wchar_t>(key));
+                history.push_back(index.search(wstringToString(query), &history.back()));
+                selected = 0;
+            }
+        }
+    }
+
+    std::vector<std::filesystem::path> getWorkspaceRoots() {
+        std::vector<std::filesystem::path> roots;
+        std::istringstream stream(getSetting("workspace_roots"));
+        for (std::string root; std::getline(stream, root, ';');) {
+            root = trimString(root);
+            if (!root.empty()) {
+                roots.push_back(std::filesystem::u8path(root));
+            }
+        }
+        return roots;
+    }
+    
+    // Индекс рабочего пространства, обновленный не раньше чем минуту назад (или принудительно).
+    // Обновление перечитывает только изменившиеся директории
+    WorkspaceIndex& getWorkspaceIndex(bool forceRefresh = false, WorkspaceIndex::RefreshStats* stats = nullptr) {
+        std::filesystem::path indexPath = getAppDataDirectory() / "workspace.idx";
+        if (!workspaceIndexLoaded) {
+            workspaceIndex.load(indexPath);
+            workspaceIndexLoaded = true;
+            forceRefresh = true;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (forceRefresh || now - workspaceRefreshedAt > std::chrono::minutes(1)) {
+            unsigned threads = std::min(8u, std::max(2u, std::thread::hardware_concurrency()));
+            WorkspaceIndex::RefreshStats result = workspaceIndex.refresh(
+                getWorkspaceRoots(), std::max(0, getIntSetting("workspace_depth", 4)), threads);
+            workspaceIndex.save(indexPath);
+            workspaceRefreshedAt = now;
+            if (stats != nullptr) {
+                *stats = result;
+            }
+        }
+        return workspaceIndex;
+    }
+    
+    // Выбор репозитория рабочего пространства по части имени; пустая строка - не выбран
+    std::string selectWorkspaceRepository(const std::wstring& query) {
+        std::vector<const WorkspaceRepository*> matches = getWorkspaceIndex().find(wstringToString(query));
+        if (matches.empty()) {
+            std::wcout << L"Репозиторий не найден в рабочем пространстве.\n";
+            return "";
+        }
+        if (matches.size() == 1) {
+            std::wcout << L"Репозиторий: " << stringToWstring(matches[0]->path) << L"\n";
+            return matches[0]->path;
+        }
+        const size_t limit = 20;
+        for (size_t i = 0; i < matches.size() && i < limit; i++) {
+            std::wcout << i + 1 << L". " << stringToWstring(matches[i]->name) << L" - " << stringToWstring(matches[i]->path)
+                      << (matches[i]->kind != "repository" ? L" [" + stringToWstring(matches[i]->kind) + L"]" : L"") << L"\n";
+        }
+        std::wcout << L"Номер репозитория: ";
+        std::wstring choice;
+        std::getline(std::wcin, choice);
+        size_t number = std::wcstoul(choice.c_str(), nullptr, 10);
+        return number >= 1 && number <= std::min(limit, matches.size()) ? matches[number - 1]->path : "";
+    }
+    
+    // Запрос директории для выполнения Git-операции
+    std::string requestGitDirectory() {
+        std::wcout << L"Текущая директория не является Git репозиторием.\n";
+        
+        // При настроенном рабочем пространстве репозиторий выбирается по имени без диалога
+        if (!getWorkspaceRoots().empty()) {
+            std::wcout << L"Имя репозитория из рабочего пространства (пусто - выбрать директорию в диалоге): ";
+            std::wstring query;
+            std::getline(std::wcin, query);
+            if (checkForHomeCommand(query)) {
+                return "";
+            }
+            if (!trimString(wstringToString(query)).empty()) {
+                std::string pathStr = selectWorkspaceRepository(query);
+                if (pathStr.empty() || (!hasCommits(pathStr) && !createInitialCommit(pathStr))) {
+                    return "";
+                }
+                return pathStr;
+            }
+        }
+        
+        // Используем диалог выбора директории вместо ручного ввода
+        std::wcout << L"Выберите директорию с Git репозиторием...\n";
+        std::wstring path = openFolderDialog(L"Выберите директорию с Git репозиторием");
+        
+        if (path.empty()) {
+            std::wcout << L"Выбор директории отменен.\n";
+            return "";
+        }
+        
+        std::string pathStr = wstringToString(path);
+        
+        // Проверяем, существует ли директория
+        if (!std::filesystem::exists(pathStr)) {
+            std::wcout << L"Указанная директория не существует!\n";
+            return "";
+        }
+        
+        // Проверяем, является ли директория Git репозиторием
+        if (!isGitRepository(pathStr)) {
+            std::wcout << L"Указанная директория не является Git репозиторием!\n";
+            std::wcout << L"Хотите инициализировать Git репозиторий в этой директории? (д/н): ";
+            wchar_t choice;
+            std::wcin >> choice;
+            std::wcin.ignore();
+            
+            if (choice == L'д' || choice == L'Д') {
+                std::string initCmd = "git init";
+                std::string result = executeCommandInDirectory(initCmd, pathStr);
+                std::wcout << stringToWstring(result) << L"\n";
+                std::wcout << L"Git репозиторий инициализирован в директории: " << path << L"\n";
+                
+                // Проверяем, что репозиторий действительно инициализирован
+                if (isGitRepository(pathStr)) {
+                    // Предлагаем создать первый коммит сразу после инициализации
+                    if (createInitialCommit(pathStr)) {
+                        return pathStr; // Возвращаем путь для продолжения операции
+                    } else {
+                        return ""; // Пользователь отказался создавать коммит
+                    }
+                } else {
+                    std::wcout << L"Не удалось инициализировать Git репозиторий!\n";
+                    return "";
+                }
+            } else {
+                return "";
+            }
+        }
+        
+        // Проверяем, есть ли коммиты в репозитории
+        if (!hasCommits(pathStr)) {
+            if (!createInitialCommit(pathStr)) {
+                return ""; // Пользователь отказался создавать коммит
+            }
+        }
+        
+        return pathStr;
+    }
+
+    // Директория данных приложения (%LOCALAPPDATA%\GitHubManager)
+    std::filesystem::path getAppDataDirectory() {
+        const char* localAppData = std::getenv("LOCALAPPDATA");
+        std::filesystem::path dir = localAppData != nullptr ?
+                                    std::filesystem::path(localAppData) / "GitHubManager" :
+                                    std::filesystem::path(wstringToString(currentDirectory)) / ".github-manager";
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        return dir;
+    }
+
+    // Список поддерживаемых настроек
+    static const std::vector<SettingInfo>& getSettingInfos() {
+        static const std::vector<SettingInfo> infos = {
+            {"branch_switch_mode", L"Режим переключения веток (checkout - git checkout, worktree - пул рабочих копий)", "checkout"},
+            {"worktree_pool_size", L"Максимальное количество рабочих копий в пуле", "4"},
+            {"worktree_pool_dir", L"Директория пула рабочих копий (пусто - рядом с репозиторием)", ""},
+            {"status_acceleration", L"Ускорение проверки состояния (auto - кэш неотслеживаемых файлов, fsmonitor - он же и fsmonitor, off)", "auto"},
+            {"api_base_url", L"Адрес GitHub REST API (например, локальный тестовый сервер)", "https://api.github.com"},
+            {"api_concurrency", L"Количество одновременных запросов к API", "6"},
+            {"api_rate_limit", L"Максимальная частота запросов к API (в секунду)", "10"},
+            {"api_max_wait", L"Максимальное ожидание (сек) восстановления лимита API перед повтором запроса", "300"},
+            {"repo_cache_ttl", L"Время (сек), в течение которого список репозиториев берется из кэша без проверки", "60"},
+            {"session_ttl_hours", L"Срок (ч), в течение которого сохраненный сеанс не проверяется запросом к API", "12"},
+            {"background_jobs", L"Выполнять отправку, клонирование и загрузку в фоне (on/off)", "on"},
+            {"job_workers", L"Количество одновременно выполняемых фоновых задач", "2"},
+            {"command_timeout", L"Предельное время выполнения команды git/gh (сек, 0 - без ограничения)", "900"},
+            {"template_ttl_days", L"Через сколько дней проверять обновление шаблонов .gitignore", "7"},
+            {"clone_cache", L"Клонирование через локальное зеркало (hardlink - копия зеркала, reference - общие объекты, off - без зеркала)", "hardlink"},
+            {"clone_concurrency", L"Количество одновременных клонирований при массовом клонировании", "4"},
+            {"workspace_roots", L"Корневые директории рабочего пространства через ';' (поиск репозиториев по имени)", ""},
+            {"workspace_depth", L"Глубина поиска репозиториев в корневых директориях", "4"},
+            {"remote_refs_ttl", L"Срок (сек) хранения списка веток удаленного репозитория для проверки перед отправкой", "30"},
+            {"dashboard_ttl", L"Срок (сек), после которого состояние репозитория в сводке пересчитывается даже без изменений в .git", "120"},
+            {"prefetch_interval", L"Период (мин) фоновой загрузки origin для репозиториев рабочего пространства (0 - отключено)", "15"},
+            {"prefetch_concurrency", L"Количество одновременных фоновых загрузок", "2"},
+            {"checkout_workers", L"Количество потоков при извлечении файлов (checkout.workers, 0 - по числу ядер)", "0"},
+        };
+        return infos;
+    }
+
+    // Загрузка настроек из файла
+    void loadSettings() {
+        std::ifstream file(getAppDataDirectory() / "settings.ini");
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t sep = line.find('=');
+            if (line.empty() || line[0] == '#' || sep == std::string::npos) {
+                continue;
+            }
+            settings[trimString(line.substr(0, sep))] = trimString(line.substr(sep + 1));
+        }
+        applyRuntimeSettings();
+    }
+
+    // Настройки, которые читаются из фоновых потоков, копируются в атомарные поля
+    void applyRuntimeSettings() {
+        commandTimeoutSeconds = getIntSetting("command_timeout", 900);
+        if (apiClient) {
+            apiClient->getScheduler().configure(getRateLimitPolicy());
+        }
+        
+        int prefetchMinutes = std::max(0, getIntSetting("prefetch_interval", 15));
+        if (prefetchMinutes > 0 && !prefetchScheduler) {
+            prefetchScheduler = std::make_unique<PrefetchScheduler>(
+                [this](const PrefetchScheduler::Target& target, const CancellationToken& cancel) {
+                    return prefetchRemote(target, cancel);
+                });
+        }
+        if (prefetchScheduler) {
+            prefetchTargetsState.clear(); // Могли измениться корни рабочего пространства
+            prefetchScheduler->configure(std::chrono::minutes(prefetchMinutes),
+                                         std::max(1, getIntSetting("prefetch_concurrency", 2)));
+        }
+    }
+    
+    // Загрузка origin в refs/prefetch/remotes/origin (поток планировщика), как git maintenance:
+    // пустой --refmap не дает обновить refs/remotes по remote.origin.fetch, FETCH_HEAD не пишется,
+    // теги и подмодули не загружаются, автоматическая сборка мусора не запускается
+    bool prefetchRemote(const PrefetchScheduler::Target& target, const CancellationToken& cancel) {
+        std::string command = "git " + gitCredentialOptions(target.url) +
+            "fetch --quiet --prune --no-tags --no-write-fetch-head --refmap= --no-auto-gc --recurse-submodules=no "
+            "origin \"+refs/heads/*:refs/prefetch/remotes/origin/*\" 2>&1";
+        return executeCommandStreaming(command, target.workDir, [](const char*, size_t) { return true; }, &cancel) == 0;
+    }
+    
+    // Ключ репозитория для планировщика: общая директория (одна для всех worktree)
+    static std::string getPrefetchKey(const std::filesystem::path& commonDir) {
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(commonDir, ec);
+        return ec ? commonDir.lexically_normal().u8string() : canonical.u8string();
+    }
+    
+    // Список репозиториев для фоновой загрузки: рабочее пространство и текущий репозиторий.
+    // Вызывается при каждом выводе меню, поэтому список строится заново только после смены
+    // текущей директории или обновления индекса рабочего пространства, а сам индекс здесь
+    // не обновляется: до первого обхода используется сохраненный на диске
+    void updatePrefetchTargets() {
+        if (!prefetchScheduler) {
+            return;
+        }
+        std::error_code ec;
+        std::filesystem::path currentPath = std::filesystem::current_path(ec);
+        std::string state = currentPath.u8string() + "|" + std::to_string(workspaceRefreshedAt.time_since_epoch().count());
+        if (state == prefetchTargetsState) {
+            return;
+        }
+        prefetchTargetsState = state;
+        
+        std::vector<PrefetchScheduler::Target> targets;
+        std::set<std::string> keys;
+        auto add = [&](const std::filesystem::path& workTree, const std::filesystem::path& commonDir) {
+            std::string url = WorkspaceIndex::readOriginUrl(commonDir);
+            std::string key = getPrefetchKey(commonDir);
+            if (!url.empty() && keys.insert(key).second) {
+                targets.push_back({key, workTree.u8string(), url});
+            }
+        };
+        
+        std::filesystem::path commonDir = findGitCommonDirectory("");
+        if (!commonDir.empty()) {
+            add(currentPath, commonDir);
+        }
+        if (!getWorkspaceRoots().empty()) {
+            WorkspaceIndex saved;
+            if (!workspaceIndexLoaded) {
+                saved.load(getAppDataDirectory() / "workspace.idx");
+            }
+            for (const WorkspaceRepository& repository :
+                 (workspaceIndexLoaded ? workspaceIndex : saved).getRepositories()) {
+                std::filesystem::path workTree = std::filesystem::u8path(repository.path);
+                add(workTree, WorkspaceIndex::commonGitDirectory(workTree));
+            }
+        }
+        prefetchScheduler->setTargets(targets);
+    }
+    
+    // Перенос загруженных в фоне ссылок в refs/remotes/origin - локально, без обращения к сети.
+    // Не выполняется, если после фоновой загрузки был обычный git fetch (его данные новее).
+    // Переносятся только перемотки вперед и ничего не удаляется: git push обновляет
+    // refs/remotes/origin, не трогая FETCH_HEAD, и более новую ссылку нельзя откатить
+    // к загруженной в фоне. Возвращает true, если ссылки могли измениться
+    bool applyPrefetchedRefs(const std::string& workDir) {
+        if (!prefetchScheduler) {
+            return false;
+        }
+        std::filesystem::path commonDir = findGitCommonDirectory(workDir);
+        if (commonDir.empty()) {
+            return false;
+        }
+        long long prefetchedAt = prefetchScheduler->takePending(getPrefetchKey(commonDir));
+        if (prefetchedAt == 0) {
+            return false;
+        }
+        std::error_code ec;
+        auto fetched = std::filesystem::last_write_time(findGitDirectory(workDir) / "FETCH_HEAD", ec);
+        if (!ec) {
+            long long fetchedAt = static_cast<long long>(std::time(nullptr)) - std::chrono::duration_cast<std::chrono::seconds>(
+                std::filesystem::file_time_type::clock::now() - fetched).count();
+            if (fetchedAt > prefetchedAt) {
+                return false;
+            }
+        }
+        // Код завершения не важен: отклоненные (не перемотка вперед) ссылки не мешают обновлению остальных
+        runCommand("git fetch --quiet --no-tags --no-write-fetch-head . "
+                   "\"refs/prefetch/remotes/origin/*:refs/remotes/origin/*\"", workDir);
+        return true;
+    }
+
+    RateLimitPolicy getRateLimitPolicy() {
+        RateLimitPolicy policy;
+        policy.maxConcurrent = std::max(1, getIntSetting("api_concurrency", 6));
+        policy.requestsPerSecond = std::max(1, getIntSetting("api_rate_limit", 10));
+        policy.burst = static_cast<int>(policy.requestsPerSecond);
+        policy.maxWait = std::chrono::seconds(std::max(0, getIntSetting("api_max_wait", 300)));
+        return policy;
+    }
+
+    // Сохранение настроек в файл
+    void saveSettings() {
+        std::ofstream file(getAppDataDirectory() / "settings.ini");
+        file << "# GitHub Manager settings\n";
+        for (const auto& setting : settings) {
+            file << setting.first << "=" << setting.second << "\n";
+        }
+    }
+
+    // Клиент API: адрес берется из настройки api_base_url или переменной GITHUB_MANAGER_API_URL
+    GitHubApiClient& getApiClient() {
+        if (!apiClient) {
+            std::string baseUrl = getSetting("api_base_url");
+            const char* overrideUrl = std::getenv("GITHUB_MANAGER_API_URL");
+            if (overrideUrl != nullptr && *overrideUrl != '\0') {
+                baseUrl = overrideUrl;
+            }
+            apiClient = std::make_unique<GitHubApiClient>(std::make_unique<WinHttpTransport>(), baseUrl);
+            apiClient->getScheduler().configure(getRateLimitPolicy());
+            apiClient->getScheduler().setWaitCallback([](std::chrono::milliseconds delay, const std::string& reason) {
+                if (ConsoleInterrupt::isMainThread()) {
+                    std::wcout << L"Ограничение API GitHub (" << std::wstring(reason.begin(), reason.end())
+                              << L"), повтор через " << (delay.count() + 999) / 1000 << L" с...\n";
+                }
+            });
+        }
+        return *apiClient;
+    }
+
+    // Токен берется из GH_TOKEN/GITHUB_TOKEN или из хранилища GitHub CLI (один запуск gh за сеанс)
+    bool loadApiToken() {
+        GitHubApiClient& client = getApiClient();
+        if (client.hasToken()) {
+            return true;
+        }
+
+        std::string token = readToken();
+        if (token.empty()) {
+            return false;
+        }
+        client.setToken(token);
+        return true;
+    }
+
+    // Чтение токена без обращения к клиенту API (безопасно для фонового потока)
+    std::string readToken() {
+        for (const char* name : {"GH_TOKEN", "GITHUB_TOKEN"}) {
+            const char* value = std::getenv(name);
+            if (value != nullptr && *value != '\0') {
+                return value;
+            }
+        }
+
+        CommandResult result = runCommand("gh auth token", "", false);
+        return result.succeeded() ? trimString(result.output) : "";
+    }
+
+    static std::string tokenFingerprint(const std::string& token) {
+        std::ostringstream stream;
+        stream << std::hex << std::hash<std::string>()("github-manager|" + token);
+        return stream.str();
+    }
+
+    std::filesystem::path getSessionPath() {
+        return getAppDataDirectory() / "session.ini";
+    }
+
+    static bool readSession(const std::filesystem::path& path, SessionInfo& session) {
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t separator = line.find('=');
+            if (separator == std::string::npos) {
+                continue;
+            }
+            std::string key = line.substr(0, separator);
+            std::string value = line.substr(separator + 1);
+            if (key == "login") session.login = value;
+            else if (key == "email") session.email = value;
+            else if (key == "scopes") session.scopes = value;
+            else if (key == "token_hash") session.tokenHash = value;
+            else if (key == "api_base_url") session.baseUrl = value;
+            else if (key == "validated_at") session.validatedAt = std::atoll(value.c_str());
+            else if (key == "expires_at") session.expiresAt = std::atoll(value.c_str());
+        }
+        return !session.login.empty() && !session.tokenHash.empty();
+    }
+
+    static void writeSession(const std::filesystem::path& path, const SessionInfo& session) {
+        std::ofstream file(path, std::ios::trunc);
+        file << "login=" << session.login << "\n"
+             << "email=" << session.email << "\n"
+             << "scopes=" << session.scopes << "\n"
+             << "token_hash=" << session.tokenHash << "\n"
+             << "api_base_url=" << session.baseUrl << "\n"
+             << "validated_at=" << session.validatedAt << "\n"
+             << "expires_at=" << session.expiresAt << "\n";
+    }
+
+    // Сохранение сеанса после успешной проверки токена
+    void saveSession() {
+        SessionInfo session;
+        session.login = wstringToString(username);
+        session.email = wstringToString(email);
+        session.scopes = tokenScopes;
+        session.tokenHash = tokenFingerprint(getApiClient().getToken());
+        session.baseUrl = getApiClient().getBaseUrl();
+        session.validatedAt = static_cast<long long>(std::time(nullptr));
+        session.expiresAt = session.validatedAt + static_cast<long long>(getIntSetting("session_ttl_hours", 12)) * 3600;
+        writeSession(getSessionPath(), session);
+    }
+
+    // Проверка сохраненного сеанса (выполняется в фоновом потоке). Если токен не изменился и срок
+    // не истек, сеанс принимается без сети; иначе токен проверяется запросом /user
+    // через отдельный клиент, чтобы не разделять соединения с основным потоком
+    SessionCheck validateSession(SessionInfo cached, int ttlSeconds) {
+        SessionCheck check;
+        check.token = readToken();
+        if (check.token.empty()) {
+            check.error = "токен GitHub CLI не найден";
+            return check;
+        }
+
+        long long now = static_cast<long long>(std::time(nullptr));
+        check.info = cached;
+        if (tokenFingerprint(check.token) == cached.tokenHash && now < cached.expiresAt) {
+            check.valid = true;
+            return check;
+        }
+
+        GitHubApiClient client(std::make_unique<WinHttpTransport>(), cached.baseUrl);
+        client.setToken(check.token);
+        HttpResponse response = client.get("/user");
+        if (!response.ok()) {
+            check.error = response.status == 0 ? response.error : "HTTP " + std::to_string(response.status);
+            return check;
+        }
+
+        JsonDocument document(response.body);
+        check.info.login = document.root()["login"].asString();
+        check.info.scopes = response.header("x-oauth-scopes");
+        check.info.tokenHash = tokenFingerprint(check.token);
+        check.info.email = trimString(runCommand("git config user.email", "", false).output);
+        check.info.validatedAt = now;
+        check.info.expiresAt = now + ttlSeconds;
+        check.valid = !check.info.login.empty();
+        return check;
+    }
+
+    // Загрузка сохраненного сеанса при запуске: данные пользователя доступны сразу,
+    // а проверка токена выполняется в фоне, пока пользователь работает с меню
+    void restoreSession() {
+        SessionInfo cached;
+        if (!readSession(getSessionPath(), cached) || cached.baseUrl != getApiClient().getBaseUrl()) {
+            return;
+        }
+
+        username = stringToWstring(cached.login);
+        email = stringToWstring(cached.email);
+        tokenScopes = cached.scopes;
+        isAuthenticated = true;
+
+        int ttlSeconds = getIntSetting("session_ttl_hours", 12) * 3600;
+        sessionCheck = std::async(std::launch::async, [this, cached, ttlSeconds]() {
+            return validateSession(cached, ttlSeconds);
+        });
+    }
+
+    // Применение результата фоновой проверки; wait - дождаться завершения проверки
+    void applySessionCheck(bool wait) {
+        if (!sessionCheck.valid()) {
+            return;
+        }
+        if (!wait && sessionCheck.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+
+        SessionCheck check = sessionCheck.get();
+        if (!check.valid) {
+            isAuthenticated = false;
+            std::wcout << L"\nСохраненный сеанс недействителен (" << stringToWstring(check.error)
+                      << L"). При следующей операции с GitHub потребуется авторизация.\n";
+            return;
+        }
+
+        getApiClient().setToken(check.token);
+        username = stringToWstring(check.info.login);
+        email = stringToWstring(check.info.email);
+        tokenScopes = check.info.scopes;
+        writeSession(getSessionPath(), check.info);
+    }
+
+    // Проверка перед операциями с GitHub: ожидает фоновую проверку сеанса, при необходимости
+    // выполняет вход
+    bool ensureAuthenticated() {
+        applySessionCheck(true);
+        if (isAuthenticated && !getApiClient().hasToken() && !loadApiToken()) {
+            isAuthenticated = false;
+        }
+        return isAuthenticated || authenticate();
+    }
+
+    // Есть ли у токена указанный доступ (неизвестный набор прав считается достаточным)
+    bool hasTokenScope(const std::string& scope) const {
+        if (tokenScopes.empty()) {
+            return true;
+        }
+        std::istringstream stream(tokenScopes);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (trimString(item) == scope) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Вывод ошибки API: код ответа и поле "message" из тела
+    void printApiError(const HttpResponse& response, const std::wstring& context) {
+        std::wcout << context;
+        if (response.status == 0) {
+            std::wcout << L": " << stringToWstring(response.error) << L"\n";
+            return;
+        }
+
+        JsonDocument document(response.body);
+        std::string message = document.root()["message"].asString();
+        if (message.empty()) {
+            message = response.error;
+        }
+        std::wcout << L" (HTTP " << response.status << L", " << static_cast<long long>(response.latencyMs) << L" мс)";
+        if (!message.empty()) {
+            std::wcout << L": " << stringToWstring(message);
+        }
+        std::wcout << L"\n";
+    }
+
+    // Номер последней страницы из заголовка Link (<...&page=N>; rel="last")
+    static int parseLastPage(const std::string& link) {
+        size_t relPos = link.find("rel=\"last\"");
+        if (relPos == std::string::npos) {
+            return 0;
+        }
+        size_t urlEnd = link.rfind('>', relPos);
+        size_t urlStart = urlEnd == std::string::npos ? std::string::npos : link.rfind('<', urlEnd);
+        if (urlStart == std::string::npos) {
+            return 0;
+        }
+
+        std::string url = link.substr(urlStart + 1, urlEnd - urlStart - 1);
+        size_t pagePos = url.find("?page=");
+        if (pagePos == std::string::npos) {
+            pagePos = url.find("&page=");
+        }
+        if (pagePos == std::string::npos) {
+            return 0;
+        }
+        return std::atoi(url.c_str() + pagePos + 6);
+    }
+
+    // Постраничная загрузка списка API с кэшем ETag. Страница 1 запрашивается первой (из нее
+    // известно число страниц), остальные - параллельно; onPage вызывается в порядке номеров
+    // страниц по мере их готовности. Возвращает false, если какую-либо страницу получить не удалось
+    bool fetchPagedList(const std::string& path, const std::string& cacheName,
+                        const std::function<void(const std::string& body)>& onPage) {
+        GitHubApiClient& client = getApiClient();
+        std::filesystem::path cacheFile = getAppDataDirectory() / "cache" /
+            (cacheName + "-" + std::to_string(std::hash<std::string>()(client.getBaseUrl() + "|" +
+                                              wstringToString(username) + "|" + path)) + ".cache");
+
+        PageCache cache;
+        cache.load(cacheFile);
+        long long now = static_cast<long long>(std::time(nullptr));
+        pagesFromCache = 0;
+        pagesFetched = 0;
+
+        // Свежий кэш отдается без обращения к сети
+        if (cache.isComplete() && now - cache.savedAt < getIntSetting("repo_cache_ttl", 60)) {
+            for (int i = 1; i <= cache.lastPage; i++) {
+                onPage(cache.find(i)->body);
+                pagesFromCache++;
+            }
+            return true;
+        }
+
+        std::string separator = path.find('?') == std::string::npos ? "?" : "&";
+        std::mutex cacheMutex;
+        std::atomic<bool> failed(false);
+        HttpResponse failure; // Первый неуспешный ответ (выводится после остановки потоков)
+        // Запрос страницы с If-None-Match; при ответе 304 тело берется из кэша
+        auto fetchPage = [&](int number, std::string& body, std::string* link) -> bool {
+            std::vector<std::pair<std::string, std::string>> headers;
+            {
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                const PageCache::Page* cached = cache.find(number);
+                if (cached != nullptr && !cached->etag.empty()) {
+                    headers.push_back({"If-None-Match", cached->etag});
+                }
+            }
+
+            HttpResponse response = client.request("GET", path + separator + "page=" + std::to_string(number), "", headers);
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            if (response.status == 304 && cache.find(number) != nullptr) {
+                body = cache.find(number)->body;
+                pagesFromCache++;
+                return true;
+            }
+            if (!response.ok()) {
+                if (failure.status == 0 && failure.error.empty()) {
+                    failure = response;
+                    failure.error += " (страница " + std::to_string(number) + ")";
+                }
+                return false;
+            }
+            if (link != nullptr) {
+                *link = response.header("link");
+            }
+            cache.put(number, response.header("etag"), response.body);
+            body = std::move(response.body);
+            pagesFetched++;
+            return true;
+        };
+
+        std::string firstBody, link;
+        if (!fetchPage(1, firstBody, &link)) {
+            printApiError(failure, L"Не удалось получить список");
+            return false;
+        }
+        // Ответ 304 не содержит Link - число страниц берется из кэша
+        int lastPage = link.empty() && pagesFromCache > 0 ? cache.lastPage : std::max(1, parseLastPage(link));
+        onPage(firstBody);
+
+        struct PageSlot {
+            bool done = false;
+            bool ok = false;
+            std::string body;
+        };
+        std::vector<PageSlot> slots(lastPage + 1);
+        std::mutex slotsMutex;
+        std::condition_variable slotReady;
+        std::atomic<int> nextPage(2);
+
+        int workerCount = std::min(std::max(1, getIntSetting("api_concurrency", 6)), std::max(1, lastPage - 1));
+        std::vector<std::thread> workers;
+        for (int w = 0; w < workerCount && lastPage > 1; w++) {
+            workers.emplace_back([&]() {
+                int number;
+                while ((number = nextPage++) <= lastPage) {
+                    std::string body;
+                    bool ok = !failed && fetchPage(number, body, nullptr);
+                    if (!ok) {
+                        failed = true;
+                    }
+                    std::lock_guard<std::mutex> lock(slotsMutex);
+                    slots[number].done = true;
+                    slots[number].ok = ok;
+                    slots[number].body = std::move(body);
+                    slotReady.notify_all();
+                }
+            });
+        }
+
+        // Вывод страниц по порядку, как только готова очередная
+        int lastNonEmpty = 1;
+        std::string lastBody = firstBody;
+        for (int number = 2; number <= lastPage; number++) {
+            std::unique_lock<std::mutex> lock(slotsMutex);
+            slotReady.wait(lock, [&]() { return slots[number].done; });
+            if (!slots[number].ok) {
+                break;
+            }
+            std::string body = std::move(slots[number].body);
+            lock.unlock();
+
+            onPage(body);
+            if (JsonDocument(body).root().size() > 0) {
+                lastNonEmpty = number;
+            }
+            lastBody = std::move(body);
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (failed) {
+            printApiError(failure, L"Не удалось получить список");
+            return false;
+        }
+
+        // Число страниц из кэша могло устареть: полная последняя страница - запрашиваем следующие
+        const size_t perPage = 100;
+        int number = lastPage;
+        while (JsonDocument(lastBody).root().size() >= perPage) {
+            number++;
+            if (!fetchPage(number, lastBody, nullptr)) {
+                printApiError(failure, L"Не удалось получить список");
+                return false;
+            }
+            onPage(lastBody);
+            if (JsonDocument(lastBody).root().size() > 0) {
+                lastNonEmpty = number;
+            }
+        }
+
+        cache.truncate(lastNonEmpty);
+        cache.savedAt = now;
+        cache.save(cacheFile);
+        return true;
+    }
+
+    // Время в формате ISO 8601 ("2024-01-02T03:04:05Z") в unix-время
+    static long long parseIsoTime(const std::string& value) {
+        std::tm time = {};
+        if (std::sscanf(value.c_str(), "%d-%d-%dT%d:%d:%d", &time.tm_year, &time.tm_mon, &time.tm_mday,
+                        &time.tm_hour, &time.tm_min, &time.tm_sec) != 6) {
+            return 0;
+        }
+        time.tm_year -= 1900;
+        time.tm_mon -= 1;
+        return static_cast<long long>(_mkgmtime(&time));
+    }
+
+    // Запись индекса из объекта репозитория REST API
+    static RepositoryRecord parseRepositoryRecord(const JsonDocument::Value& repo) {
+        RepositoryRecord record;
+        record.fullName = repo["full_name"].asString();
+        record.description = repo["description"].asString();
+        record.language = repo["language"].asString();
+        record.pushedAt = parseIsoTime(repo["pushed_at"].asString());
+        record.isPrivate = repo["private"].asBool();
+        repo["topics"].forEach([&record](const JsonDocument::Value& topic) {
+            if (!record.topics.empty()) {
+                record.topics += " ";
+            }
+            record.topics += topic.asString();
+        });
+        return record;
+    }
+
+    std::filesystem::path getRepositoryIndexPath() {
+        return getAppDataDirectory() / ("repos-" + std::to_string(std::hash<std::string>()(
+            getApiClient().getBaseUrl() + "|" + wstringToString(username))) + ".idx");
+    }
+
+    // Обновление индекса репозиториев. Полная перестройка выполняется при отсутствии индекса
+    // и раз в сутки (переименованные и удаленные репозитории); иначе запрашиваются только
+    // репозитории, отправленные позже самой свежей записи индекса (sort=pushed)
+    bool refreshRepositoryIndex(bool forceFull = false) {
+        std::filesystem::path path = getRepositoryIndexPath();
+        long long now = static_cast<long long>(std::time(nullptr));
+        bool full = forceFull || !repositoryIndex.open(path) || now - repositoryIndex.fullBuildAt() > 24 * 60 * 60;
+
+        std::vector<RepositoryRecord> records;
+        long long fullBuildAt = now;
+        if (full) {
+            std::wcout << L"Построение индекса репозиториев...\n";
+            bool complete = fetchPagedList("/user/repos?per_page=100&sort=full_name", "repos",
+                                           [&records](const std::string& body) {
+                JsonDocument(body).root().forEach([&records](const JsonDocument::Value& repo) {
+                    records.push_back(parseRepositoryRecord(repo));
+                });
+            });
+            if (!complete) {
+                return repositoryIndex.isOpen();
+            }
+        } else {
+            fullBuildAt = repositoryIndex.fullBuildAt();
+            long long since = repositoryIndex.newestPush();
+            std::map<std::string, RepositoryRecord> updated;
+            bool reachedKnown = false;
+            for (int page = 1; !reachedKnown; page++) {
+                HttpResponse response = getApiClient().get("/user/repos?per_page=100&sort=pushed&direction=desc&page=" +
+                                                           std::to_string(page));
+                JsonDocument document(response.body);
+                if (!response.ok() || !document.root().isArray()) {
+                    printApiError(response, L"Не удалось обновить индекс репозиториев");
+                    return true; // Остается прежний индекс
+                }
+                document.root().forEach([&](const JsonDocument::Value& repo) {
+                    RepositoryRecord record = parseRepositoryRecord(repo);
+                    if (record.pushedAt <= since) {
+                        reachedKnown = true;
+                    } else if (!reachedKnown) {
+                        updated[record.fullName] = std::move(record);
+                    }
+                });
+                if (document.root().size() < 100) {
+                    break;
+                }
+            }
+            if (updated.empty()) {
+                return true;
+            }
+
+            records = repositoryIndex.records();
+            for (RepositoryRecord& record : records) {
+                auto it = updated.find(record.fullName);
+                if (it != updated.end()) {
+                    record = std::move(it->second);
+                    updated.erase(it);
+                }
+            }
+            for (auto& entry : updated) {
+                records.push_back(std::move(entry.second));
+            }
+        }
+
+        repositoryIndex.close();
+        RepositoryIndex::write(path, std::move(records), fullBuildAt);
+        return repositoryIndex.open(path);
+    }
+
+    // Удаление репозитория из индекса (после удаления на GitHub)
+    void removeFromRepositoryIndex(const std::string& slug) {
+        int index = repositoryIndex.isOpen() ? repositoryIndex.find(slug) : -1;
+        if (index < 0) {
+            return;
+        }
+
+        std::string fullName(repositoryIndex.fullName(static_cast<uint32_t>(index)));
+        std::vector<RepositoryRecord> records = repositoryIndex.records();
+        long long fullBuildAt = repositoryIndex.fullBuildAt();
+        records.erase(std::remove_if(records.begin(), records.end(), [&fullName](const RepositoryRecord& record) {
+            return record.fullName == fullName;
+        }), records.end());
+
+        std::filesystem::path path = getRepositoryIndexPath();
+        repositoryIndex.close();
+        RepositoryIndex::write(path, std::move(records), fullBuildAt);
+        repositoryIndex.open(path);
+    }
+
+    // Выбор репозитория по введенной строке: URL возвращается как есть, точное полное имя
+    // принимается сразу, иначе выполняется поиск по индексу и пользователь выбирает из списка.
+    // Пустая строка - отмена. allowUnknown = false (для необратимых операций): строка,
+    // не найденная в индексе, не принимается, а без индекса принимается только полное имя
+    std::string selectRepository(const std::wstring& input, bool allowUnknown = true) {
+        std::string query = trimString(wstringToString(input));
+        if (query.empty() || query.find("://") != std::string::npos || query.rfind("git@", 0) == 0) {
+            return allowUnknown ? query : "";
+        }
+
+        if (!repositoryIndexRefreshed) {
+            refreshRepositoryIndex();
+            repositoryIndexRefreshed = true;
+        }
+        if (!repositoryIndex.isOpen()) {
+            return allowUnknown || query.find('/') != std::string::npos ? query : "";
+        }
+
+        int exact = repositoryIndex.find(query.find('/') == std::string::npos ?
+                                         wstringToString(username) + "/" + query : query);
+        if (exact >= 0) {
+            return std::string(repositoryIndex.fullName(static_cast<uint32_t>(exact)));
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        std::vector<uint32_t> matches = repositoryIndex.search(query, 20);
+        long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count();
+
+        if (matches.empty()) {
+            if (!allowUnknown) {
+                std::wcout << L"Репозиторий не найден в индексе (" << repositoryIndex.size() << L" репозиториев).\n";
+                return "";
+            }
+            // Индекс может еще не знать о репозитории - имя используется как введено
+            std::wcout << L"Репозиторий не найден в индексе (" << repositoryIndex.size()
+                      << L" репозиториев), используется имя '" << stringToWstring(query) << L"'.\n";
+            return query;
+        }
+
+        std::wcout << L"Найдено (" << elapsed << L" мкс):\n";
+        for (size_t i = 0; i < matches.size(); i++) {
+            RepositoryRecord record = repositoryIndex.record(matches[i]);
+            std::wcout << (i + 1) << L". " << stringToWstring(record.fullName)
+                      << (record.isPrivate ? L" [PRIVATE]" : L"");
+            if (!record.language.empty()) {
+                std::wcout << L" (" << stringToWstring(record.language) << L")";
+            }
+            if (!record.description.empty()) {
+                std::wcout << L" - " << stringToWstring(record.description);
+            }
+            std::wcout << L"\n";
+        }
+
+        std::wcout << L"Введите номер репозитория (пусто - отмена): ";
+        std::wstring choiceStr;
+        std::getline(std::wcin, choiceStr);
+        size_t choice = 0;
+        try {
+            choice = static_cast<size_t>(std::stoi(choiceStr));
+        } catch (const std::exception&) {
+            return "";
+        }
+        if (choice < 1 || choice > matches.size()) {
+            return "";
+        }
+        return std::string(repositoryIndex.fullName(matches[choice - 1]));
+    }
+
+    // Добавляет в пакет запрос состояния лимита GraphQL API; строка для вывода записывается в line
+    void addRateLimitQuery(GraphQLBatch& batch, std::wstring& line) {
+        batch.add("rateLimit { limit remaining resetAt }", [this, &line](const JsonDocument::Value& rateLimit) {
+            line = L"Лимит API: осталось " + std::to_wstring(rateLimit["remaining"].asInt()) + L" из " +
+                   std::to_wstring(rateLimit["limit"].asInt()) + L" (сброс " +
+                   stringToWstring(rateLimit["resetAt"].asString()) + L")";
+        });
+    }
+
+    // Создание репозитория текущего пользователя через API
+    HttpResponse createRemoteRepository(const std::wstring& name, bool isPrivate, const std::wstring& description = L"") {
+        std::string body = "{\"name\":\"" + JsonDocument::escape(wstringToString(name)) + "\"," +
+                           "\"private\":" + (isPrivate ? "true" : "false");
+        if (!description.empty()) {
+            body += ",\"description\":\"" + JsonDocument::escape(wstringToString(description)) + "\"";
+        }
+        body += "}";
+        return getApiClient().post("/user/repos", body);
+    }
+
+    // "owner/repo" из адреса GitHub (https://github.com/owner/repo.git или git@github.com:owner/repo.git)
+    static std::string parseGitHubSlug(const std::string& url) {
+        size_t hostPos = url.find("github.com");
+        if (hostPos == std::string::npos) {
+            return "";
+        }
+
+        std::string slug = url.substr(hostPos + 10);
+        if (slug.empty() || (slug[0] != '/' && slug[0] != ':')) {
+            return "";
+        }
+        slug.erase(0, 1);
+        while (!slug.empty() && slug.back() == '/') {
+            slug.pop_back();
+        }
+        if (slug.size() > 4 && slug.compare(slug.size() - 4, 4, ".git") == 0) {
+            slug.erase(slug.size() - 4);
+        }
+        return std::count(slug.begin(), slug.end(), '/') == 1 ? slug : "";
+    }
+
+    // Репозиторий GitHub, на который указывает origin
+    std::string getOriginSlug(const std::string& workDir = "") {
+        CommandResult result = runCommand("git remote get-url origin", workDir, false);
+        return result.succeeded() ? parseGitHubSlug(trimString(result.output)) : "";
+    }
+
+    JobManager& getJobManager() {
+        if (!jobManager) {
+            jobManager = std::make_unique<JobManager>(static_cast<size_t>(getIntSetting("job_workers", 2)));
+        }
+        return *jobManager;
+    }
+
+    // Выполнение команды внутри задачи: вывод попадает в журнал задачи, при отмене чтение прекращается
+    int runJobCommand(Job& job, const std::string& command, const std::string& workDir) {
+        job.appendText("> " + command + "\n");
+        int exitCode = executeCommandStreaming(command + " 2>&1", workDir, [&job](const char* data, size_t size) {
+            job.appendOutput(data, size);
+            return true;
+        }, &job.getCancellation());
+
+        if (exitCode == ChildProcess::ExitTimedOut) {
+            job.appendText("Команда прервана: превышено время ожидания\n");
+        } else if (exitCode == ChildProcess::ExitCancelled) {
+            job.appendText("Команда отменена\n");
+        }
+        return exitCode;
+    }
+
+    static std::wstring jobStateName(Job::State state) {
+        switch (state) {
+            case Job::State::Queued: return L"в очереди";
+            case Job::State::Running: return L"выполняется";
+            case Job::State::Succeeded: return L"выполнена";
+            case Job::State::Failed: return L"ошибка";
+            case Job::State::Cancelled: return L"отменена";
+        }
+        return L"";
+    }
+
+    // Запуск длительной операции как фоновой задачи. Директория фиксируется при запуске
+    // (пустая строка - текущая). При background_jobs=off задача выполняется с ожиданием
+    void startJob(const std::wstring& title, std::string workDir,
+                  std::function<bool(Job&, const std::string&)> work) {
+        if (workDir.empty()) {
+            workDir = std::filesystem::current_path().string();
+        }
+        std::shared_ptr<Job> job = getJobManager().submit(title, workDir,
+            [work, workDir](Job& job) { return work(job, workDir); });
+
+        if (getSetting("background_jobs") == "off") {
+            waitForJob(job);
+            return;
+        }
+        std::wcout << L"Задача #" << job->id << L" (" << title << L") запущена в фоне. "
+                  << L"Состояние задач: пункт 31 меню.\n";
+    }
+
+    // Ожидание задачи со строкой прогресса; по завершении выводится журнал
+    void waitForJob(const std::shared_ptr<Job>& job) {
+        while (!getJobManager().waitFor(job, std::chrono::milliseconds(250))) {
+            std::wcout << L"\r#" << job->id << L" " << jobStateName(job->getState());
+            if (job->getProgress() >= 0) {
+                std::wcout << L" " << job->getProgress() << L"% " << stringToWstring(job->getPhase());
+            }
+            std::wcout << L" (" << static_cast<int>(job->elapsedSeconds()) << L" с)   " << std::flush;
+        }
+        std::wcout << L"\r";
+        std::wcout << stringToWstring(job->getLog());
+        printJobResult(*job);
+    }
+
+    void printJobResult(const Job& job) {
+        std::wcout << L"[Задача #" << job.id << L"] " << job.title << L": " << jobStateName(job.getState())
+                  << L" за " << formatFixed(job.elapsedSeconds()) << L" с\n";
+    }
+
+    // Уведомления о завершенных задачах (выводятся между запросами меню)
+    void printJobNotices() {
+        if (!jobManager) {
+            return;
+        }
+        for (const auto& job : jobManager->takeFinished()) {
+            printJobResult(*job);
+            if (job->getState() == Job::State::Failed) {
+                std::wcout << L"  Журнал задачи: пункт 31 меню, команда 'l " << job->id << L"'\n";
             }
         }
-
-        _pclose(pipe);
-        return result;
     }
 
-    // Выполнение команды в указанной директории
-    std::string executeCommandInDirectory(const std::string& command, const std::string& directory) {
-        // Сохраняем текущую директорию
-        char currentDir[MAX_PATH];
-        GetCurrentDirectoryA(MAX_PATH, currentDir);
-        
-        // Переходим в указанную директорию
-        SetCurrentDirectoryA(directory.c_str());
-        
-        // Выполняем команду
-        std::string result = executeCommand(command);
-        
-        // Возвращаемся в исходную директорию
-        SetCurrentDirectoryA(currentDir);
-        
-        return result;
+    // Значение настройки (или значение по умолчанию)
+    std::string getSetting(const std::string& key) {
+        auto it = settings.find(key);
+        if (it != settings.end()) {
+            return it->second;
+        }
+        for (const auto& info : getSettingInfos()) {
+            if (info.key == key) {
+                return info.defaultValue;
+            }
+        }
+        return "";
     }
 
-    // Конвертация из string в wstring
-    std::wstring stringToWstring(const std::string& str) {
-        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-        return converter.from_bytes(str);
+    // Числовое значение настройки
+    int getIntSetting(const std::string& key, int fallback) {
+        try {
+            return std::stoi(getSetting(key));
+        } catch (const std::exception&) {
+            return fallback;
+        }
     }
 
-    // Конвертация из wstring в string
-    std::string wstringToString(const std::wstring& wstr) {
-        std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-        return converter.to_bytes(wstr);
+    // Смена рабочей директории процесса (например, после перехода в рабочую копию из пула).
+    // Путь в UTF-8, как его выводит git
+    bool changeWorkingDirectory(const std::string& path) {
+        std::wstring directory = stringToWstring(path);
+        if (!SetCurrentDirectoryW(directory.c_str())) {
+            std::wcout << L"Не удалось перейти в директорию: " << directory << L"\n";
+            return false;
+        }
+        currentDirectory = directory;
+        std::wcout << L"Рабочая директория: " << currentDirectory << L"\n";
+        return true;
     }
 
-    // Проверка, находимся ли мы в директории Git репозитория
-    bool isGitRepository() {
-        std::string result = executeCommand("git rev-parse --is-inside-work-tree 2>nul");
-        return (result.find("true") != std::string::npos);
+    // Имя директории для ветки: символы, недопустимые в пути, заменяются на '-'
+    static std::string sanitizeBranchForPath(const std::string& branch) {
+        std::string result = branch;
+        for (char& c : result) {
+            if (std::string("/\\:*?\"<>| ").find(c) != std::string::npos) {
+                c = '-';
+            }
+        }
+        return result;
     }
 
-    // Проверка, является ли указанная директория Git репозиторием
-    bool isGitRepository(const std::string& directory) {
-        std::string result = executeCommandInDirectory("git rev-parse --is-inside-work-tree 2>nul", directory);
-        return (result.find("true") != std::string::npos);
-    }
+    // Все рабочие копии репозитория: ветка -> путь (первая запись - основная рабочая копия)
+    std::vector<std::pair<std::string, std::string>> listWorktrees(const std::string& workDir) {
+        std::vector<std::pair<std::string, std::string>> worktrees;
+        std::string output = executeCommandInWorkDir("git worktree list --porcelain", workDir);
 
-    // Проверка, хочет ли пользователь вернуться в главное меню
-    bool checkForHomeCommand(const std::wstring& input) {
-        std::wstring lowerInput = input;
-        std::transform(lowerInput.begin(), lowerInput.end(), lowerInput.begin(), ::tolower);
-        return (lowerInput == L"home" || lowerInput == L"домой" || lowerInput == L"меню" || lowerInput == L"выход");
+        std::istringstream stream(output);
+        std::string line;
+        std::string path;
+        const std::string branchPrefix = "branch refs/heads/";
+
+        while (std::getline(stream, line)) {
+            line = trimString(line);
+            if (line.compare(0, 9, "worktree ") == 0) {
+                path = line.substr(9);
+                worktrees.push_back({"", path});
+            } else if (line.compare(0, branchPrefix.size(), branchPrefix) == 0 && !worktrees.empty()) {
+                worktrees.back().first = line.substr(branchPrefix.size());
+            }
+        }
+        return worktrees;
     }
 
-    // Создание первого коммита в репозитории
-    bool createInitialCommit(const std::string& workDir = "") {
-        std::wcout << L"В репозитории пока нет коммитов. Необходимо сделать первый коммит.\n";
-        std::wcout << L"Хотите создать первый коммит? (д/н): ";
-        wchar_t choice;
-        std::wcin >> choice;
-        std::wcin.ignore();
-        
-        if (choice == L'д' || choice == L'Д') {
-            // Создаем пустой README.md для первого коммита
-            std::string createReadmeCmd = "echo # New Repository > README.md";
-            std::string addCmd = "git add README.md";
-            std::string commitCmd = "git commit -m \"Initial commit\"";
-            
-            if (workDir.empty()) {
-                executeCommand(createReadmeCmd);
-                executeCommand(addCmd);
-                std::string result = executeCommand(commitCmd);
-                std::wcout << stringToWstring(result) << L"\n";
-            } else {
-                executeCommandInDirectory(createReadmeCmd, workDir);
-                executeCommandInDirectory(addCmd, workDir);
-                std::string result = executeCommandInDirectory(commitCmd, workDir);
-                std::wcout << stringToWstring(result) << L"\n";
+    // Загрузка состояния пула: строки "<время использования>|<ветка>|<путь>"
+    std::vector<WorktreeEntry> loadWorktreePool(const std::filesystem::path& commonDir) {
+        std::vector<WorktreeEntry> pool;
+        std::ifstream file(commonDir / "github-manager-worktrees");
+        std::string line;
+
+        while (std::getline(file, line)) {
+            size_t first = line.find('|');
+            size_t second = line.find('|', first + 1);
+            if (first == std::string::npos || second == std::string::npos) {
+                continue;
             }
-            
-            std::wcout << L"Первый коммит создан. Теперь можно работать с ветками.\n";
-            return true;
-        } else {
-            std::wcout << L"Операция отменена. Создайте первый коммит для работы с ветками.\n";
-            return false;
+
+            WorktreeEntry entry;
+            try {
+                entry.lastUsed = std::stoll(line.substr(0, first));
+            } catch (const std::exception&) {
+                entry.lastUsed = 0;
+            }
+            entry.branch = line.substr(first + 1, second - first - 1);
+            entry.path = trimString(line.substr(second + 1));
+            pool.push_back(entry);
         }
+        return pool;
     }
 
-    // Проверка наличия коммитов в репозитории
-    bool hasCommits(const std::string& workDir = "") {
-        std::string revParseCmd = "git rev-parse --verify HEAD 2>nul";
-        std::string revParseResult;
-        
-        if (workDir.empty()) {
-            revParseResult = executeCommand(revParseCmd);
-        } else {
-            revParseResult = executeCommandInDirectory(revParseCmd, workDir);
+    // Сохранение состояния пула
+    void saveWorktreePool(const std::filesystem::path& commonDir, const std::vector<WorktreeEntry>& pool) {
+        std::ofstream file(commonDir / "github-manager-worktrees");
+        for (const auto& entry : pool) {
+            file << entry.lastUsed << "|" << entry.branch << "|" << entry.path << "\n";
         }
-        
-        return !(revParseResult.empty() || revParseResult.find("fatal") != std::string::npos);
     }
 
-    // Запрос директории для выполнения Git-операции
-    std::string requestGitDirectory() {
-        std::wcout << L"Текущая директория не является Git репозиторием.\n";
-        
-        // Используем диалог выбора директории вместо ручного ввода
-        std::wcout << L"Выберите директорию с Git репозиторием...\n";
-        std::wstring path = openFolderDialog(L"Выберите директорию с Git репозиторием");
-        
-        if (path.empty()) {
-            std::wcout << L"Выбор директории отменен.\n";
+    // Получение рабочей копии для ветки из пула.
+    // Если ветка уже где-то извлечена, возвращается ее путь без обращения к файлам.
+    // Иначе создается новая рабочая копия или переиспользуется давно не использованная.
+    // startPoint не пуст - создается новая ветка от указанного коммита.
+    std::string acquireWorktree(const std::string& workDir, const std::string& branch, const std::string& startPoint = "") {
+        std::filesystem::path commonDir = findGitCommonDirectory(workDir);
+        if (commonDir.empty()) {
+            std::wcout << L"Не удалось найти директорию .git репозитория.\n";
             return "";
         }
-        
-        std::string pathStr = wstringToString(path);
-        
-        // Проверяем, существует ли директория
-        if (!std::filesystem::exists(pathStr)) {
-            std::wcout << L"Указанная директория не существует!\n";
+
+        std::vector<std::pair<std::string, std::string>> worktrees = listWorktrees(workDir);
+        if (worktrees.empty()) {
+            std::wcout << L"Не удалось получить список рабочих копий.\n";
             return "";
         }
-        
-        // Проверяем, является ли директория Git репозиторием
-        if (!isGitRepository(pathStr)) {
-            std::wcout << L"Указанная директория не является Git репозиторием!\n";
-            std::wcout << L"Хотите инициализировать Git репозиторий в этой директории? (д/н): ";
-            wchar_t choice;
-            std::wcin >> choice;
-            std::wcin.ignore();
-            
-            if (choice == L'д' || choice == L'Д') {
-                std::string initCmd = "git init";
-                std::string result = executeCommandInDirectory(initCmd, pathStr);
-                std::wcout << stringToWstring(result) << L"\n";
-                std::wcout << L"Git репозиторий инициализирован в директории: " << path << L"\n";
-                
-                // Проверяем, что репозиторий действительно инициализирован
-                if (isGitRepository(pathStr)) {
-                    // Предлагаем создать первый коммит сразу после инициализации
-                    if (createInitialCommit(pathStr)) {
-                        return pathStr; // Возвращаем путь для продолжения операции
-                    } else {
-                        return ""; // Пользователь отказался создавать коммит
+
+        // Сверяем пул с реальным состоянием: убираем удаленные копии и обновляем ветки
+        std::vector<WorktreeEntry> pool;
+        for (auto& entry : loadWorktreePool(commonDir)) {
+            for (const auto& worktree : worktrees) {
+                if (std::filesystem::path(worktree.second) == std::filesystem::path(entry.path)) {
+                    entry.branch = worktree.first;
+                    pool.push_back(entry);
+                    break;
+                }
+            }
+        }
+
+        long long now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        // Ветка уже извлечена в одной из рабочих копий - переключение мгновенное
+        if (startPoint.empty()) {
+            for (const auto& worktree : worktrees) {
+                if (worktree.first == branch) {
+                    for (auto& entry : pool) {
+                        if (std::filesystem::path(entry.path) == std::filesystem::path(worktree.second)) {
+                            entry.lastUsed = now;
+                        }
                     }
-                } else {
-                    std::wcout << L"Не удалось инициализировать Git репозиторий!\n";
-                    return "";
+                    saveWorktreePool(commonDir, pool);
+                    return worktree.second;
                 }
-            } else {
-                return "";
             }
         }
-        
-        // Проверяем, есть ли коммиты в репозитории
-        if (!hasCommits(pathStr)) {
-            if (!createInitialCommit(pathStr)) {
-                return ""; // Пользователь отказался создавать коммит
+
+        std::string newBranchArgs = startPoint.empty() ? "" : " -b " + branch;
+        std::string target = startPoint.empty() ? branch : startPoint;
+        size_t capacity = static_cast<size_t>(std::max(1, getIntSetting("worktree_pool_size", 4)));
+
+        if (pool.size() >= capacity) {
+            // Переиспользуем наименее недавно использованную копию без несохраненных изменений
+            std::sort(pool.begin(), pool.end(), [](const WorktreeEntry& a, const WorktreeEntry& b) {
+                return a.lastUsed < b.lastUsed;
+            });
+
+            for (auto& entry : pool) {
+                if (isWorkingTreeDirty(entry.path)) {
+                    continue;
+                }
+
+                std::wcout << L"Переиспользуется рабочая копия ветки '" << stringToWstring(entry.branch) << L"'...\n";
+                std::string checkoutCmd = startPoint.empty() ?
+                                          "git checkout " + branch :
+                                          "git checkout -b " + branch + " " + startPoint;
+                CommandResult result = runCommand(checkoutCmd, entry.path);
+
+                if (!result.succeeded()) {
+                    std::wcout << stringToWstring(result.output) << L"\n";
+                    return "";
+                }
+
+                entry.branch = branch;
+                entry.lastUsed = now;
+                saveWorktreePool(commonDir, pool);
+                return entry.path;
             }
+
+            std::wcout << L"Во всех рабочих копиях пула есть несохраненные изменения, создается дополнительная.\n";
         }
-        
-        return pathStr;
+
+        // Создаем новую рабочую копию
+        std::filesystem::path mainPath = worktrees.front().second;
+        std::string poolDirSetting = getSetting("worktree_pool_dir");
+        std::filesystem::path poolDir = poolDirSetting.empty() ?
+                                        mainPath.parent_path() / (mainPath.filename().string() + ".worktrees") :
+                                        std::filesystem::path(poolDirSetting) / mainPath.filename();
+        std::filesystem::path worktreePath = poolDir / sanitizeBranchForPath(branch);
+
+        std::error_code ec;
+        std::filesystem::create_directories(poolDir, ec);
+
+        std::wcout << L"Создание рабочей копии для ветки '" << stringToWstring(branch) << L"'...\n";
+        std::string addCmd = "git worktree add" + newBranchArgs + " \"" + worktreePath.string() + "\" " + target;
+        CommandResult result = runCommand(addCmd, workDir);
+
+        if (!result.succeeded()) {
+            std::wcout << stringToWstring(result.output) << L"\n";
+            std::wcout << L"Не удалось создать рабочую копию.\n";
+            return "";
+        }
+
+        pool.push_back({branch, worktreePath.string(), now});
+        saveWorktreePool(commonDir, pool);
+        return worktreePath.string();
     }
 
 public:
@@ -218,43 +6068,101 @@ public:
         SetConsoleOutputCP(CP_UTF8);
         SetConsoleCP(CP_UTF8);
         
+        // Включаем управляющие последовательности для перерисовки строк при выборе веток
+        HANDLE consoleOutput = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD consoleMode = 0;
+        if (GetConsoleMode(consoleOutput, &consoleMode)) {
+            SetConsoleMode(consoleOutput, consoleMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+        }
+        
         // Сохраняем текущую директорию
         char currentDir[MAX_PATH];
         GetCurrentDirectoryA(MAX_PATH, currentDir);
         currentDirectory = stringToWstring(currentDir);
+        
+        // Ctrl-C прерывает выполняемую команду, а не программу
+        ConsoleInterrupt::install();
+        
+        loadSettings();
+        restoreSession();
     }
 
-    // Аутентификация через GitHub CLI
-    bool authenticate() {
-        std::wcout << L"Проверка аутентификации GitHub CLI...\n";
-        std::string result = executeCommand("gh auth status");
+    // Фоновые потоки используют члены класса, поэтому останавливаются до их уничтожения
+    ~GitHubManager() {
+        prefetchScheduler.reset();
+        if (jobManager) {
+            jobManager->shutdown(true);
+        }
+        if (sessionCheck.valid()) {
+            sessionCheck.wait();
+        }
+    }
 
-        if (result.find("not logged") != std::string::npos) {
+    // Аутентификация: токен GitHub CLI проверяется запросом к API
+    bool authenticate() {
+        std::wcout << L"Проверка аутентификации GitHub...\n";
+        if (!loadApiToken()) {
             std::wcout << L"Вы не авторизованы в GitHub CLI. Выполняется вход...\n";
-            result = executeCommand("gh auth login -w");
+            executeCommand("gh auth login -w");
             std::wcout << L"Откройте браузер и выполните инструкции по авторизации.\n";
             std::wcout << L"После авторизации нажмите Enter для продолжения...";
             std::cin.ignore();
             std::cin.get();
+            loadApiToken();
         }
         
-        result = executeCommand("gh auth status");
-        isAuthenticated = (result.find("not logged") == std::string::npos);
+        isAuthenticated = getApiClient().hasToken() && loadUserInfo();
         
         if (isAuthenticated) {
             std::wcout << L"Авторизация успешна!\n";
-            loadUserInfo();
+            saveSession();
         }
         
         return isAuthenticated;
     }
 
     // Загрузка информации о пользователе
-    void loadUserInfo() {
-        std::string usernameStr = executeCommand("gh api user -q .login");
-        if (!usernameStr.empty()) {
-            usernameStr.erase(usernameStr.find_last_not_of("\r\n") + 1);
-            username = stringToWstring(usernameStr);
+    // Логин, остаток лимита API и счетчики задач текущего репозитория запрашиваются одним пакетом
+    bool loadUserInfo() {
+        GraphQLBatch batch;
+        std::string login;
+        batch.add("viewer { login }", [&login](const JsonDocument::Value& viewer) {
+            login = viewer["login"].asString();
+        });
+
+        std::wstring rateLimitLine;
+        addRateLimitQuery(batch, rateLimitLine);
+
+        std::wstring repositoryLine;
+        std::string slug = getOriginSlug();
+        if (!slug.empty()) {
+            size_t slash = slug.find('/');
+            batch.add("repository(owner: " + GraphQLBatch::quote(slug.substr(0, slash)) +
+                      ", name: " + GraphQLBatch::quote(slug.substr(slash + 1)) + ") { " +
+                      "issues(states: OPEN) { totalCount } pullRequests(states: OPEN) { totalCount } }",
+                      [this, &repositoryLine, slug](const JsonDocument::Value& repository) {
+                repositoryLine = L"Репозиторий " + stringToWstring(slug) + L": открытых задач " +
+                                 std::to_wstring(repository["issues"]["totalCount"].asInt()) +
+                                 L", открытых pull request " +
+                                 std::to_wstring(repository["pullRequests"]["totalCount"].asInt());
+            });
+        }
+
+        HttpResponse response = batch.execute(getApiClient());
+        if (login.empty()) {
+            printApiError(response, L"Не удалось получить данные пользователя");
+            return false;
+        }
+        username = stringToWstring(login);
+        tokenScopes = response.header("x-oauth-scopes");
+
+        std::wcout << L"Пользователь: " << username << L" (ответ API за "
+                  << static_cast<long long>(response.latencyMs) << L" мс)\n";
+        if (!rateLimitLine.empty()) {
+            std::wcout << rateLimitLine << L"\n";
+        }
+        if (!repositoryLine.empty()) {
+            std::wcout << repositoryLine << L"\n";
         }
 
         std::string emailStr = executeCommand("git config user.email");
@@ -262,6 +6170,7 @@ public:
             emailStr.erase(emailStr.find_last_not_of("\r\n") + 1);
             email = stringToWstring(emailStr);
         }
+        return true;
     }
 
     // Функция для выбора файлов через стандартный диалог Windows
@@ -400,9 +6309,204 @@ public:
         return selectedFolder;
     }
 
+    // Параметры создаваемого проекта
+    struct ProjectPlan {
+        std::wstring name;
+        std::wstring description;
+        bool isPrivate = false;
+        std::string localPath;
+        std::shared_ptr<const std::vector<SeedFile>> files;  // Файлы для копирования в проект
+        std::shared_ptr<const TextTemplate> readme;          // nullptr - README по умолчанию
+        std::string gitignore;                               // Пусто - без .gitignore
+        bool interactivePush = true;                         // Отправка в потоке меню (запрос учетных данных)
+    };
+
+    // Результаты шагов создания проекта, нужные для отката и итогового отчета
+    struct ProjectState {
+        bool createdDirectory = false;
+        bool createdGitDir = false;
+        std::vector<std::filesystem::path> createdDocuments;  // README.md и .gitignore
+        std::vector<std::filesystem::path> copiedFiles;       // Файлы, которых не было в директории
+        int copiedCount = 0;
+        int unchangedCount = 0;                               // Совпали с заготовкой по хешу
+        std::string remoteSlug;
+        std::string cloneUrl;
+        std::string htmlUrl;
+    };
+
+    // README по умолчанию; разбирается один раз
+    static const TextTemplate& getDefaultReadmeTemplate() {
+        static const TextTemplate readme(
+            "# {{name}}\n\n"
+            "{{description}}"
+            "## Содержание\n\n"
+            "- [Установка](#установка)\n"
+            "- [Использование](#использование)\n"
+            "- [Лицензия](#лицензия)\n\n"
+            "## Установка\n\n"
+            "```\n"
+            "# Клонирование репозитория\n"
+            "git clone https://github.com/{{owner}}/{{name}}.git\n"
+            "cd {{name}}\n"
+            "```\n\n"
+            "## Использование\n\n"
+            "Добавьте примеры использования.\n\n"
+            "## Лицензия\n\n"
+            "Этот проект лицензирован под [MIT License](LICENSE).\n");
+        return readme;
+    }
+
+    // Шаги создания проекта: репозиторий на GitHub создается параллельно с локальной
+    // подготовкой (директория, git init, README, файлы), связывание и отправка ждут обе ветви.
+    // plan и state должны существовать, пока выполняется граф
+    void addProjectSteps(TaskGraph& graph, const ProjectPlan& plan, ProjectState& state) {
+        graph.add("remote", L"Создание репозитория на GitHub", {}, [this, &plan, &state](std::string& message) {
+            HttpResponse response = createRemoteRepository(plan.name, plan.isPrivate, plan.description);
+            JsonDocument document(response.body);
+            if (!response.ok()) {
+                message = document.root()["message"].asString();
+                message = "HTTP " + std::to_string(response.status) + (message.empty() ? response.error : ": " + message);
+                return false;
+            }
+            state.remoteSlug = document.root()["full_name"].asString();
+            state.cloneUrl = document.root()["clone_url"].asString();
+            state.htmlUrl = document.root()["html_url"].asString();
+            return true;
+        }, [this, &state](std::string& message) {
+            if (!hasTokenScope("delete_repo")) {
+                message = "нет права delete_repo, удалите репозиторий вручную: " + state.htmlUrl;
+                return false;
+            }
+            HttpResponse response = getApiClient().del("/repos/" + state.remoteSlug);
+            message = response.ok() ? "удален " + state.remoteSlug : "HTTP " + std::to_string(response.status);
+            return response.ok();
+        });
+        
+        graph.add("directory", L"Создание директории проекта", {}, [&plan, &state](std::string& message) {
+            if (!std::filesystem::exists(plan.localPath)) {
+                std::filesystem::create_directories(plan.localPath);
+                state.createdDirectory = true;
+                message = plan.localPath;
+            }
+            return true;
+        }, [&plan, &state](std::string&) {
+            std::error_code ec;
+            if (state.createdDirectory) {
+                std::filesystem::remove_all(plan.localPath, ec);
+            }
+            return !ec;
+        });
+        
+        graph.add("init", L"Инициализация локального репозитория", {"directory"}, [this, &plan, &state](std::string& message) {
+            state.createdGitDir = !std::filesystem::exists(std::filesystem::path(plan.localPath) / ".git");
+            CommandResult result = runCommand("git init", plan.localPath);
+            message = trimString(result.output);
+            return result.succeeded();
+        }, [&plan, &state](std::string&) {
+            std::error_code ec;
+            if (state.createdGitDir && !state.createdDirectory) {
+                std::filesystem::remove_all(std::filesystem::path(plan.localPath) / ".git", ec);
+            }
+            return !ec;
+        });
+        
+        graph.add("readme", L"Создание README.md и .gitignore", {"directory"}, [this, &plan, &state](std::string&) {
+            std::string description = wstringToString(plan.description);
+            std::map<std::string, std::string> values = {
+                {"name", wstringToString(plan.name)},
+                {"description", description.empty() ? "" : description + "\n\n"},
+                {"owner", wstringToString(username)},
+                {"visibility", plan.isPrivate ? "private" : "public"},
+            };
+            const TextTemplate& readme = plan.readme ? *plan.readme : getDefaultReadmeTemplate();
+            std::vector<std::pair<std::string, std::string>> documents = {{"README.md", readme.render(values)}};
+            if (!plan.gitignore.empty()) {
+                documents.push_back({".gitignore", plan.gitignore});
+            }
+            for (const auto& document : documents) {
+                std::filesystem::path path = std::filesystem::path(plan.localPath) / document.first;
+                if (std::filesystem::exists(path)) {
+                    continue;
+                }
+                std::ofstream file(path, std::ios::binary);
+                file << document.second;
+                if (!file) {
+                    return false;
+                }
+                state.createdDocuments.push_back(path);
+            }
+            return true;
+        }, [&state](std::string&) {
+            for (const auto& path : state.createdDocuments) {
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+            return true;
+        });
+        
+        // После readme: выбранный для копирования README.md или .gitignore заменяет созданный
+        graph.add("copy", L"Копирование файлов", {"directory", "readme"}, [this, &plan, &state](std::string& message) {
+            if (!plan.files) {
+                return true;
+            }
+            for (const SeedFile& file : *plan.files) {
+                std::filesystem::path destPath = std::filesystem::path(plan.localPath) / file.relative;
+                if (!destPath.parent_path().empty()) {
+                    std::filesystem::create_directories(destPath.parent_path());
+                }
+                std::error_code ec;
+                bool existed = std::filesystem::exists(destPath);
+                // Совпадающий с заготовкой файл не копируется повторно
+                if (existed && file.hash != 0 && std::filesystem::file_size(destPath, ec) == file.size &&
+                    SeedFile::hashFile(destPath) == file.hash) {
+                    state.unchangedCount++;
+                    continue;
+                }
+                std::filesystem::copy_file(file.source, destPath, std::filesystem::copy_options::overwrite_existing, ec);
+                if (ec) {
+                    message += wstringToString(file.source.wstring()) + ": " + ec.message() + "\n";
+                    continue;
+                }
+                state.copiedCount++;
+                if (!existed) {
+                    state.copiedFiles.push_back(destPath);
+                }
+            }
+            message += "скопировано " + std::to_string(state.copiedCount) + " из " + std::to_string(plan.files->size());
+            return true;
+        }, [&state](std::string&) {
+            for (const auto& path : state.copiedFiles) {
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+            return true;
+        });
+        
+        graph.add("commit", L"Создание начального коммита", {"init", "readme", "copy"}, [this, &plan](std::string& message) {
+            CommandResult result = runCommand("git add . && git commit -m \"Initial commit\"", plan.localPath);
+            message = trimString(result.output);
+            return result.succeeded();
+        });
+        
+        graph.add("link", L"Связывание с удаленным репозиторием", {"init", "remote"}, [this, &plan, &state](std::string& message) {
+            CommandResult result = runCommand("git remote add origin " + state.cloneUrl, plan.localPath);
+            message = trimString(result.output);
+            return result.succeeded();
+        }, [this, &plan](std::string&) {
+            return runCommand("git remote remove origin", plan.localPath).succeeded();
+        });
+        
+        // В интерактивном режиме отправка выполняется в потоке меню: git может запросить учетные данные
+        graph.add("push", L"Отправка на GitHub", {"commit", "link"}, [this, &plan](std::string& message) {
+            CommandResult result = runCommand("git push -u origin HEAD", plan.localPath);
+            message = trimString(result.output);
+            return result.succeeded();
+        }, nullptr, plan.interactivePush);
+    }
+
     // Создать полный проект (репозиторий + локальный проект)
     void createFullProject() {
-        if (!isAuthenticated && !authenticate()) return;
+        if (!ensureAuthenticated()) return;
 
         // Запрашиваем информацию о репозитории
         std::wstring repoName, description;
@@ -446,7 +6550,7 @@ public:
             return;
         }
         
-        std::string visibility = (choice == 1) ? "--private" : "--public";
+        bool isPrivate = (choice == 1);
         
         // Запрашиваем локальную директорию для проекта через диалог выбора папки
         std::wcout << L"Выберите директорию для создания локального проекта...\n";
@@ -464,92 +6568,20 @@ public:
             localPathStr += "\\" + wstringToString(repoName);
         }
         
-        // Создаем директорию, если она не существует
-        if (!std::filesystem::exists(localPathStr)) {
-            try {
-                std::filesystem::create_directories(localPathStr);
-                std::wcout << L"Создана директория: " << stringToWstring(localPathStr) << L"\n";
-            } catch (const std::exception& e) {
-                std::wcout << L"Ошибка при создании директории: " << stringToWstring(e.what()) << L"\n";
-                return;
-            }
-        }
-        
-        // Создаем репозиторий на GitHub
-        std::wcout << L"Создание репозитория на GitHub...\n";
-        std::string cmd = "gh repo create " + wstringToString(repoName) + " " + visibility;
-        if (!description.empty()) {
-            cmd += " --description \"" + wstringToString(description) + "\"";
-        }
-        
-        std::string result = executeCommand(cmd);
-        std::wcout << stringToWstring(result) << L"\n";
-        
-        // Проверяем успешность создания репозитория
-        bool repoCreated = result.find("Created repository") != std::string::npos || 
-                          result.find("HTTP 201") != std::string::npos ||
-                          result.find("https://github.com/") != std::string::npos;
-                          
-        // Если в выводе есть сообщение об ошибке, считаем, что репозиторий не создан
-        bool hasError = result.find("GraphQL:") != std::string::npos && 
-                       result.find("error") != std::string::npos;
-                       
-        if (!repoCreated || hasError) {
-            std::wcout << L"Ошибка при создании репозитория на GitHub. Проверьте вывод выше.\n";
-            return;
-        }
-        
-        // Инициализируем локальный репозиторий
-        std::wcout << L"Инициализация локального репозитория...\n";
-        std::string initCmd = "git init";
-        result = executeCommandInDirectory(initCmd, localPathStr);
-        std::wcout << stringToWstring(result) << L"\n";
-        
-        // Создаем README.md
-        std::string readmePath = localPathStr + "/README.md";
-        if (!std::filesystem::exists(readmePath)) {
-            std::ofstream readmeFile(readmePath);
-            readmeFile << "# " << wstringToString(repoName) << "\n\n";
-            
-            if (!description.empty()) {
-                readmeFile << wstringToString(description) << "\n\n";
-            }
-            
-            readmeFile << "## Содержание\n\n";
-            readmeFile << "- [Установка](#установка)\n";
-            readmeFile << "- [Использование](#использование)\n";
-            readmeFile << "- [Лицензия](#лицензия)\n\n";
-            
-            readmeFile << "## Установка\n\n";
-            readmeFile << "```\n";
-            readmeFile << "# Клонирование репозитория\n";
-            readmeFile << "git clone https://github.com/" << wstringToString(username) << "/" << wstringToString(repoName) << ".git\n";
-            readmeFile << "cd " << wstringToString(repoName) << "\n";
-            readmeFile << "```\n\n";
-            
-            readmeFile << "## Использование\n\n";
-            readmeFile << "Добавьте примеры использования.\n\n";
-            
-            readmeFile << "## Лицензия\n\n";
-            readmeFile << "Этот проект лицензирован под [MIT License](LICENSE).\n";
-            
-            readmeFile.close();
-            std::wcout << L"Создан файл README.md\n";
-        }
-        
-        // Спрашиваем, хочет ли пользователь добавить файлы
+        // Спрашиваем, хочет ли пользователь добавить файлы (все вопросы задаются до начала создания)
         std::wcout << L"Хотите добавить файлы в проект? (д/н): ";
         wchar_t addFiles;
         std::wcin >> addFiles;
         std::wcin.ignore();
         
+        std::wstring sourceDirPath;
         std::vector<std::wstring> selectedFilePaths;
         bool keepStructure = false;
         
         if (addFiles == L'д' || addFiles == L'Д') {
             // Запрашиваем исходную директорию с файлами через диалог
             std::wcout << L"Выберите директорию с исходными файлами...\n";
-            std::wstring sourceDirPath = openFolderDialog(L"Выберите директорию с исходными файлами");
+            sourceDirPath = openFolderDialog(L"Выберите директорию с исходными файлами");
             
             if (sourceDirPath.empty()) {
                 std::wcout << L"Директория не выбрана. Продолжаем без добавления файлов.\n";
@@ -570,72 +6602,304 @@ public:
                     std::wcin.ignore();
                     
                     keepStructure = (preserveStructure == L'д' || preserveStructure == L'Д');
-                    
-                    // Копируем выбранные файлы
-                    int copiedCount = 0;
-                    for (const auto& srcPath : selectedFilePaths) {
-                        std::filesystem::path src(srcPath);
-                        std::filesystem::path relativePath;
-                        
-                        if (keepStructure) {
-                            // Получаем относительный путь от исходной директории
-                            relativePath = std::filesystem::relative(src, sourceDirPath);
-                        } else {
-                            // Используем только имя файла
-                            relativePath = src.filename();
-                        }
-                        
-                        // Формируем полный целевой путь
-                        std::filesystem::path destPath = localPathStr + "/" + relativePath.string();
-                        
-                        // Создаем промежуточные директории, если нужно
-                        std::filesystem::path destDir = destPath.parent_path();
-                        if (!destDir.empty() && !std::filesystem::exists(destDir)) {
-                            std::filesystem::create_directories(destDir);
-                        }
-                        
-                        try {
-                            std::filesystem::copy_file(src, destPath, 
-                                                     std::filesystem::copy_options::overwrite_existing);
-                            std::wcout << L"Файл скопирован: " << src.wstring() << L" -> " << destPath.wstring() << L"\n";
-                            copiedCount++;
-                        } catch (const std::exception& e) {
-                            std::wcout << L"Ошибка при копировании файла " << src.wstring() << L": " 
-                                      << stringToWstring(e.what()) << L"\n";
-                        }
-                    }
-                    
-                    std::wcout << L"Скопировано " << copiedCount << L" из " << selectedFilePaths.size() << L" файлов.\n";
                 }
             }
         }
         
-        // Добавляем файлы в Git и создаем коммит
-        std::string addCmd = "git add .";
-        result = executeCommandInDirectory(addCmd, localPathStr);
-        std::wcout << L"Файлы добавлены в индекс Git.\n";
+        ProjectPlan plan;
+        plan.name = repoName;
+        plan.description = description;
+        plan.isPrivate = isPrivate;
+        plan.localPath = localPathStr;
+        auto files = std::make_shared<std::vector<SeedFile>>();
+        for (const auto& srcPath : selectedFilePaths) {
+            SeedFile file;
+            file.source = srcPath;
+            // Относительный путь от исходной директории или только имя файла
+            file.relative = keepStructure ? std::filesystem::relative(file.source, sourceDirPath) : file.source.filename();
+            files->push_back(std::move(file));
+        }
+        plan.files = files;
+        
+        ProjectState state;
+        TaskGraph graph;
+        addProjectSteps(graph, plan, state);
+        
+        auto started = std::chrono::steady_clock::now();
+        auto printStep = [this](const TaskGraph::Step& step) {
+            if (step.state == TaskGraph::State::Running) {
+                std::wcout << L"> " << step.title << L"...\n";
+                return;
+            }
+            std::wcout << (step.state == TaskGraph::State::Done ? L"[OK] " : L"[Ошибка] ") << step.title
+                      << L" (" << formatFixed(step.seconds) << L" с)";
+            if (!step.message.empty()) {
+                std::wcout << L": " << stringToWstring(step.message);
+            }
+            std::wcout << L"\n";
+        };
+        bool succeeded = graph.run(std::max(2, getIntSetting("api_concurrency", 6)), printStep);
+        
+        double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        double sumSeconds = 0;
+        for (const auto& step : graph.getSteps()) {
+            sumSeconds += step.seconds;
+        }
+        std::wcout << L"Общее время: " << formatFixed(totalSeconds)
+                  << L" с (последовательно: " << formatFixed(sumSeconds) << L" с)\n";
+        
+        if (!succeeded) {
+            std::wcout << L"Создание проекта не завершено. Откатить выполненные шаги "
+                      << L"(удалить созданный репозиторий на GitHub и созданные файлы)? (д/н): ";
+            std::wstring answer;
+            std::getline(std::wcin, answer);
+            if (answer == L"д" || answer == L"Д") {
+                graph.rollback([this](const TaskGraph::Step& step) {
+                    std::wcout << L"Отменено: " << step.title;
+                    if (!step.message.empty()) {
+                        std::wcout << L" (" << stringToWstring(step.message) << L")";
+                    }
+                    std::wcout << L"\n";
+                });
+            }
+            return;
+        }
+        
+        std::wcout << L"Проект успешно создан в папке: " << stringToWstring(localPathStr) << L"\n";
+        std::wcout << L"Репозиторий доступен по адресу: " << stringToWstring(state.htmlUrl) << L"\n";
+    }
+
+    // Проект из манифеста вместе с графом его создания
+    struct ScaffoldItem {
+        ProjectPlan plan;
+        ProjectState state;
+        TaskGraph graph;
+        std::string error;      // Ошибка манифеста или шага, на котором создание остановилось
+        std::string seedDir;    // Ключ заготовки в общей таблице
+        bool succeeded = false;
+        double seconds = 0;
+    };
+
+    // Массовое создание проектов по манифесту JSON: массив проектов или объект
+    // {"root": ..., "defaults": {...}, "projects": [...]}. Поля проекта: name, description,
+    // private, path, readme (файл шаблона с подстановками {{name}}, {{description}}, {{owner}},
+    // {{visibility}}), gitignore (имя шаблона GitHub или файл), seed (директория-заготовка).
+    // Шаблоны разбираются, а заготовки хешируются один раз для всех проектов
+    void scaffoldProjects() {
+        if (!ensureAuthenticated()) return;
+        
+        std::wcout << L"Путь к файлу манифеста (JSON): ";
+        std::wstring input;
+        std::getline(std::wcin, input);
+        if (checkForHomeCommand(input)) {
+            return;
+        }
+        std::string manifestName = trimString(wstringToString(input));
+        if (manifestName.size() >= 2 && manifestName.front() == '"' && manifestName.back() == '"') {
+            manifestName = manifestName.substr(1, manifestName.size() - 2);
+        }
+        std::ifstream manifestFile(manifestName, std::ios::binary);
+        std::string manifestText((std::istreambuf_iterator<char>(manifestFile)), std::istreambuf_iterator<char>());
+        JsonDocument manifest(manifestText);
+        if (!manifestFile.is_open() || !manifest.isValid()) {
+            std::wcout << L"Не удалось прочитать манифест (ожидается JSON).\n";
+            return;
+        }
         
-        std::string commitCmd = "git commit -m \"Initial commit\"";
-        result = executeCommandInDirectory(commitCmd, localPathStr);
-        std::wcout << stringToWstring(result) << L"\n";
+        std::error_code ec;
+        std::filesystem::path baseDir = std::filesystem::absolute(manifestName, ec).parent_path();
+        auto resolve = [&baseDir](const std::string& path) {
+            std::filesystem::path result(path);
+            return result.is_absolute() ? result : baseDir / result;
+        };
+        JsonDocument::Value root = manifest.root();
+        JsonDocument::Value projects = root.isArray() ? root : root["projects"];
+        JsonDocument::Value defaults = root["defaults"];
+        std::filesystem::path projectsRoot = root["root"].isString() ? resolve(root["root"].asString()) : baseDir;
+        
+        // Общие для всех проектов ресурсы: каждый шаблон и каждая заготовка обрабатываются один раз
+        std::map<std::string, std::shared_ptr<const TextTemplate>> readmeTemplates;
+        std::map<std::string, std::string> gitignoreTemplates;
+        std::map<std::string, std::shared_future<std::shared_ptr<const std::vector<SeedFile>>>> seeds;
+        
+        std::deque<ScaffoldItem> items;
+        projects.forEach([&](const JsonDocument::Value& project) {
+            auto field = [&project, &defaults](const char* name) {
+                return project[name].exists() ? project[name] : defaults[name];
+            };
+            ScaffoldItem& item = items.emplace_back();
+            std::string name = field("name").asString();
+            item.plan.name = stringToWstring(name);
+            item.plan.description = stringToWstring(field("description").asString());
+            item.plan.isPrivate = field("private").asBool(field("visibility").asString() != "public");
+            item.plan.localPath = (field("path").isString() ? resolve(field("path").asString()) : projectsRoot / name).string();
+            item.plan.interactivePush = false;
+            if (name.empty()) {
+                item.error = "нет имени (name)";
+                return;
+            }
+            
+            std::string readme = field("readme").asString();
+            if (!readme.empty()) {
+                auto it = readmeTemplates.find(readme);
+                if (it == readmeTemplates.end()) {
+                    std::ifstream file(resolve(readme), std::ios::binary);
+                    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                    it = readmeTemplates.emplace(readme, file.is_open() ? std::make_shared<TextTemplate>(text) : nullptr).first;
+                }
+                if (!it->second) {
+                    item.error = "не найден шаблон README: " + readme;
+                    return;
+                }
+                item.plan.readme = it->second;
+            }
+            
+            std::string gitignore = field("gitignore").asString();
+            if (!gitignore.empty()) {
+                auto it = gitignoreTemplates.find(gitignore);
+                if (it == gitignoreTemplates.end()) {
+                    std::ifstream file(resolve(gitignore), std::ios::binary);
+                    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                    if (!file.is_open()) {
+                        // Не файл - имя шаблона GitHub (C++, Python, Node, ...) из локального хранилища
+                        const std::string* stored = getGitignoreTemplates().find(gitignore);
+                        text = stored != nullptr ? *stored : "";
+                    }
+                    it = gitignoreTemplates.emplace(gitignore, text).first;
+                }
+                if (it->second.empty()) {
+                    item.error = "не найден шаблон .gitignore: " + gitignore;
+                    return;
+                }
+                item.plan.gitignore = it->second;
+            }
+            
+            std::string seed = field("seed").asString();
+            if (!seed.empty()) {
+                std::filesystem::path seedDir = resolve(seed);
+                if (!std::filesystem::is_directory(seedDir)) {
+                    item.error = "не найдена директория-заготовка: " + seed;
+                    return;
+                }
+                item.seedDir = seedDir.string();
+                if (seeds.find(item.seedDir) == seeds.end()) {
+                    seeds[seedDir.string()] = std::async(std::launch::async, [seedDir]() {
+                        return std::shared_ptr<const std::vector<SeedFile>>(
+                            std::make_shared<std::vector<SeedFile>>(SeedFile::collect(seedDir)));
+                    }).share();
+                }
+            }
+        });
         
-        // Связываем локальный и удаленный репозитории
-        std::string remoteCmd = "git remote add origin https://github.com/" + 
-                              wstringToString(username) + "/" + wstringToString(repoName) + ".git";
-        result = executeCommandInDirectory(remoteCmd, localPathStr);
+        if (items.empty()) {
+            std::wcout << L"Манифест не содержит проектов.\n";
+            return;
+        }
         
-        // Push в удаленный репозиторий
-        std::string pushCmd = "git push -u origin master";
-        result = executeCommandInDirectory(pushCmd, localPathStr);
-        std::wcout << stringToWstring(result) << L"\n";
+        std::wcout << L"Проектов в манифесте: " << items.size() << L"\n";
+        for (const ScaffoldItem& item : items) {
+            std::wcout << L"  " << item.plan.name << (item.plan.isPrivate ? L" (приватный)" : L" (публичный)") << L" -> "
+                      << stringToWstring(item.plan.localPath);
+            if (!item.error.empty()) {
+                std::wcout << L" [" << stringToWstring(item.error) << L"]";
+            }
+            std::wcout << L"\n";
+        }
+        std::wcout << L"Создать проекты? (д/н): ";
+        std::getline(std::wcin, input);
+        if (input != L"д" && input != L"Д") {
+            return;
+        }
         
-        std::wcout << L"Проект успешно создан в папке: " << stringToWstring(localPathStr) << L"\n";
-        std::wcout << L"Репозиторий доступен по адресу: https://github.com/" << username << L"/" << repoName << L"\n";
+        // Заготовки хешировались параллельно, пока пользователь читал список
+        for (ScaffoldItem& item : items) {
+            if (item.error.empty() && !item.seedDir.empty()) {
+                item.plan.files = seeds[item.seedDir].get();
+            }
+        }
+        
+        std::mutex outputMutex;
+        std::atomic<size_t> nextItem(0);
+        std::atomic<int> finished(0);
+        auto started = std::chrono::steady_clock::now();
+        auto worker = [&]() {
+            size_t position;
+            while ((position = nextItem++) < items.size()) {
+                ScaffoldItem& item = items[position];
+                if (item.error.empty()) {
+                    auto itemStarted = std::chrono::steady_clock::now();
+                    addProjectSteps(item.graph, item.plan, item.state);
+                    // Внутри проекта параллельны создание репозитория и локальная подготовка
+                    item.succeeded = item.graph.run(2, [](const TaskGraph::Step&) {});
+                    item.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - itemStarted).count();
+                    for (const auto& step : item.graph.getSteps()) {
+                        if (step.state == TaskGraph::State::Failed) {
+                            item.error = wstringToString(step.title) + ": " + step.message;
+                        }
+                    }
+                }
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::wcout << L"[" << ++finished << L"/" << items.size() << L"] " << item.plan.name
+                          << (item.succeeded ? L" - создан" : L" - ошибка") << L"\n";
+            }
+        };
+        std::vector<std::thread> workers;
+        int workerCount = std::min<int>(std::max(1, getIntSetting("api_concurrency", 6)), static_cast<int>(items.size()));
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+        double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        
+        // Итоговая таблица
+        size_t nameWidth = 6;
+        for (const ScaffoldItem& item : items) {
+            nameWidth = std::max(nameWidth, item.plan.name.size());
+        }
+        int failedCount = 0;
+        std::wcout << L"\n" << std::left << std::setw(static_cast<int>(nameWidth)) << L"Проект" << L"  "
+                  << std::setw(8) << L"Итог" << L"  " << std::setw(7) << L"Файлы" << L"  " << std::setw(7) << L"Время"
+                  << L"  Адрес / ошибка\n";
+        for (const ScaffoldItem& item : items) {
+            std::wstring time = formatFixed(item.seconds) + L" с";
+            std::wcout << std::left << std::setw(static_cast<int>(nameWidth)) << item.plan.name << L"  "
+                      << std::setw(8) << (item.succeeded ? L"OK" : L"ОШИБКА") << L"  "
+                      << std::setw(7) << item.state.copiedCount + item.state.unchangedCount << L"  "
+                      << std::setw(7) << time << L"  "
+                      << stringToWstring(item.succeeded ? item.state.htmlUrl : item.error) << L"\n";
+            failedCount += item.succeeded ? 0 : 1;
+        }
+        std::wcout << std::right << L"Создано проектов: " << items.size() - failedCount << L" из " << items.size()
+                  << L" за " << formatFixed(totalSeconds) << L" с\n";
+        
+        if (failedCount > 0) {
+            std::wcout << L"Откатить выполненные шаги незавершенных проектов (удалить их репозитории на GitHub "
+                      << L"и созданные файлы)? (д/н): ";
+            std::getline(std::wcin, input);
+            if (input == L"д" || input == L"Д") {
+                bool undone = true;
+                for (ScaffoldItem& item : items) {
+                    if (!item.succeeded) {
+                        undone = item.graph.rollback([this, &item](const TaskGraph::Step& step) {
+                            std::wcout << L"[" << item.plan.name << L"] Отменено: " << step.title;
+                            if (!step.message.empty()) {
+                                std::wcout << L" (" << stringToWstring(step.message) << L")";
+                            }
+                            std::wcout << L"\n";
+                        }) && undone;
+                    }
+                }
+                std::wcout << (undone ? L"Откат выполнен.\n" :
+                                        L"Откат выполнен не полностью, см. сообщения выше.\n");
+            }
+        }
     }
 
     // Создать репозиторий на GitHub
     void createGitHubRepository() {
-        if (!isAuthenticated && !authenticate()) return;
+        if (!ensureAuthenticated()) return;
 
         std::wstring repoName, description;
         std::wcout << L"Введите имя репозитория: ";
@@ -653,30 +6917,14 @@ public:
         std::wcin >> choice;
         std::wcin.ignore();
         
-        std::string visibility = (choice == 1) ? "--private" : "--public";
-        
-        std::string cmd = "gh repo create " + wstringToString(repoName) + " " + visibility;
-        if (!description.empty()) {
-            cmd += " --description \"" + wstringToString(description) + "\"";
-        }
-        
-        std::string result = executeCommand(cmd);
-        std::wcout << stringToWstring(result) << L"\n";
+        HttpResponse response = createRemoteRepository(repoName, choice == 1, description);
         
-        // Проверяем успешность создания репозитория
-        bool repoCreated = result.find("Created repository") != std::string::npos || 
-                          result.find("HTTP 201") != std::string::npos ||
-                          result.find("https://github.com/") != std::string::npos;
-                          
-        // Если в выводе есть сообщение об ошибке, считаем, что репозиторий не создан
-        bool hasError = result.find("GraphQL:") != std::string::npos && 
-                       result.find("error") != std::string::npos;
-                       
-        if (!repoCreated || hasError) {
-            std::wcout << L"Ошибка при создании репозитория на GitHub. Проверьте вывод выше.\n";
+        if (!response.ok()) {
+            printApiError(response, L"Ошибка при создании репозитория на GitHub");
         } else {
+            JsonDocument document(response.body);
             std::wcout << L"Репозиторий успешно создан!\n";
-            std::wcout << L"Репозиторий доступен по адресу: https://github.com/" << username << L"/" << repoName << L"\n";
+            std::wcout << L"Репозиторий доступен по адресу: " << stringToWstring(document.root()["html_url"].asString()) << L"\n";
         }
     }
 
@@ -718,31 +6966,29 @@ public:
         std::wcout << L"Введите URL удаленного репозитория: ";
         std::getline(std::wcin, remoteUrl);
 
-        std::string cmd = "git remote add origin " + wstringToString(remoteUrl);
-        std::string result = executeCommand(cmd);
-        
-        // Проверяем, есть ли ошибки в выводе команды
-        if (result.find("error") != std::string::npos || result.find("fatal") != std::string::npos) {
-            std::wcout << L"Ошибка при связывании репозиториев: " << stringToWstring(result) << L"\n";
+        // Проверяем, существует ли уже remote с именем origin
+        if (hasRemote("origin", "")) {
+            std::wcout << L"Remote с именем 'origin' уже существует. Хотите обновить URL? (д/н): ";
+            wchar_t updateChoice;
+            std::wcin >> updateChoice;
+            std::wcin.ignore();
             
-            // Проверяем, существует ли уже remote с именем origin
-            if (result.find("remote origin already exists") != std::string::npos) {
-                std::wcout << L"Remote с именем 'origin' уже существует. Хотите обновить URL? (д/н): ";
-                wchar_t updateChoice;
-                std::wcin >> updateChoice;
-                std::wcin.ignore();
-                
-                if (updateChoice == L'д' || updateChoice == L'Д') {
-                    cmd = "git remote set-url origin " + wstringToString(remoteUrl);
-                    result = executeCommand(cmd);
-                    std::wcout << L"URL удаленного репозитория обновлен!\n";
-                } else {
-                    return;
-                }
-            } else {
+            if (updateChoice != L'д' && updateChoice != L'Д') {
                 return;
             }
+            
+            CommandResult setUrlResult = runCommand("git remote set-url origin " + wstringToString(remoteUrl));
+            if (!setUrlResult.succeeded()) {
+                std::wcout << L"Ошибка при обновлении URL: " << stringToWstring(setUrlResult.output) << L"\n";
+                return;
+            }
+            std::wcout << L"URL удаленного репозитория обновлен!\n";
         } else {
+            CommandResult addResult = runCommand("git remote add origin " + wstringToString(remoteUrl));
+            if (!addResult.succeeded()) {
+                std::wcout << L"Ошибка при связывании репозиториев: " << stringToWstring(addResult.output) << L"\n";
+                return;
+            }
             std::wcout << L"Локальный репозиторий связан с удаленным!\n";
         }
         
@@ -753,11 +6999,19 @@ public:
         std::wcin.ignore();
         
         if (pushChoice == L'д' || pushChoice == L'Д') {
-            result = executeCommand("git push -u origin master");
-            std::wcout << stringToWstring(result) << L"\n";
+            PushCheck check = checkBranchPush("origin", "master", "master", "");
+            if (check.upToDate()) {
+                setBranchUpstream("master", "origin", "");
+                std::wcout << L"Ветка master на удаленном репозитории уже совпадает с локальной, push не требуется.\n";
+                return;
+            }
+            
+            CommandResult pushResult = runCommand("git push -u origin master");
+            recordPush(check, "master", "master", pushResult.succeeded(), "");
+            std::wcout << stringToWstring(pushResult.output) << L"\n";
             
             // Проверяем успешность push
-            if (result.find("error") != std::string::npos || result.find("fatal") != std::string::npos) {
+            if (!pushResult.succeeded()) {
                 std::wcout << L"Ошибка при выполнении push. Проверьте вывод выше.\n";
             } else {
                 std::wcout << L"Push выполнен успешно!\n";
@@ -765,6 +7019,98 @@ public:
         }
     }
 
+    std::filesystem::path getTemplatesDirectory() {
+        return getAppDataDirectory() / "templates";
+    }
+
+    // Шаблоны .gitignore: с диска, а при отсутствии или устаревании (template_ttl_days) -
+    // из репозитория github/gitignore одним GraphQL-запросом. Без сети используется сохраненная копия
+    const TemplateStore& getGitignoreTemplates() {
+        if (!gitignoreStoreLoaded) {
+            gitignoreStore.load(getTemplatesDirectory() / "gitignore.store");
+            gitignoreStoreLoaded = true;
+        }
+        long long now = static_cast<long long>(std::time(nullptr));
+        long long ttl = static_cast<long long>(std::max(0, getIntSetting("template_ttl_days", 7))) * 24 * 60 * 60;
+        if ((gitignoreStore.empty() || now - gitignoreStore.fetchedAt > ttl) && loadApiToken()) {
+            refreshGitignoreTemplates();
+        }
+        return gitignoreStore;
+    }
+
+    // Проверка версии шаблонов; тексты загружаются, только если дерево шаблонов изменилось
+    bool refreshGitignoreTemplates() {
+        const std::string repository = "repository(owner: \"github\", name: \"gitignore\") ";
+        long long now = static_cast<long long>(std::time(nullptr));
+        if (!gitignoreStore.empty()) {
+            GraphQLBatch check;
+            std::string version;
+            check.add(repository + "{ object(expression: \"HEAD:\") { oid } }",
+                      [&version](const JsonDocument::Value& value) {
+                version = value["object"]["oid"].asString();
+            });
+            check.execute(getApiClient());
+            if (version.empty()) {
+                return false; // Нет сети - остается сохраненная копия
+            }
+            if (version == gitignoreStore.version) {
+                gitignoreStore.fetchedAt = now;
+                return gitignoreStore.save(getTemplatesDirectory() / "gitignore.store");
+            }
+        }
+
+        std::wcout << L"Загрузка шаблонов .gitignore...\n";
+        GraphQLBatch batch;
+        std::string version;
+        std::map<std::string, std::string> templates;
+        batch.add(repository + "{ object(expression: \"HEAD:\") { oid ... on Tree { entries { name object { ... on Blob { text } } } } } }",
+                  [&](const JsonDocument::Value& value) {
+            version = value["object"]["oid"].asString();
+            value["object"]["entries"].forEach([&templates](const JsonDocument::Value& entry) {
+                std::string name = entry["name"].asString();
+                const std::string suffix = ".gitignore";
+                if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                    templates[name.substr(0, name.size() - suffix.size())] = entry["object"]["text"].asString();
+                }
+            });
+        });
+        HttpResponse response = batch.execute(getApiClient());
+        if (templates.empty()) {
+            printApiError(response, L"Не удалось загрузить шаблоны .gitignore");
+            return false;
+        }
+        gitignoreStore.replace(std::move(templates), version, now);
+        return gitignoreStore.save(getTemplatesDirectory() / "gitignore.store");
+    }
+
+    // Шаблон README: пустое имя - стандартный, иначе файл templates\readme\<имя>.md.
+    // Каждый шаблон разбирается один раз за сеанс; nullptr - шаблон не найден
+    std::shared_ptr<const TextTemplate> getReadmeTemplate(const std::string& name) {
+        if (name.empty()) {
+            return std::shared_ptr<const TextTemplate>(&getDefaultReadmeTemplate(), [](const TextTemplate*) {});
+        }
+        auto it = readmeTemplateCache.find(name);
+        if (it == readmeTemplateCache.end()) {
+            std::ifstream file(getTemplatesDirectory() / "readme" / (name + ".md"), std::ios::binary);
+            std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            it = readmeTemplateCache.emplace(name, file.is_open() ? std::make_shared<TextTemplate>(std::move(text)) : nullptr).first;
+        }
+        return it->second;
+    }
+
+    // Имена пользовательских шаблонов README
+    std::vector<std::string> listReadmeTemplates() {
+        std::vector<std::string> names;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(getTemplatesDirectory() / "readme", ec)) {
+            if (entry.path().extension() == ".md") {
+                names.push_back(entry.path().stem().string());
+            }
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
     // Создать файл README.md
     void createReadmeFile() {
         std::wstring projectName, description;
@@ -775,31 +7121,36 @@ public:
         std::wcout << L"Введите описание проекта (опционально): ";
         std::getline(std::wcin, description);
         
-        std::ofstream readmeFile("README.md");
-        readmeFile << "# " << wstringToString(projectName) << "\n\n";
-        
-        if (!description.empty()) {
-            readmeFile << wstringToString(description) << "\n\n";
+        // Пользовательские шаблоны из %LOCALAPPDATA%\GitHubManager\templates\readme
+        std::string templateName;
+        std::vector<std::string> names = listReadmeTemplates();
+        if (!names.empty()) {
+            std::wcout << L"Шаблон README:\n0. Стандартный\n";
+            for (size_t i = 0; i < names.size(); i++) {
+                std::wcout << i + 1 << L". " << stringToWstring(names[i]) << L"\n";
+            }
+            std::wcout << L"Ваш выбор: ";
+            std::wstring choice;
+            std::getline(std::wcin, choice);
+            size_t number = std::wcstoul(choice.c_str(), nullptr, 10);
+            if (number >= 1 && number <= names.size()) {
+                templateName = names[number - 1];
+            }
         }
         
-        readmeFile << "## Содержание\n\n";
-        readmeFile << "- [Установка](#установка)\n";
-        readmeFile << "- [Использование](#использование)\n";
-        readmeFile << "- [Лицензия](#лицензия)\n\n";
-        
-        readmeFile << "## Установка\n\n";
-        readmeFile << "```\n";
-        readmeFile << "# Клонирование репозитория\n";
-        readmeFile << "git clone https://github.com/username/" << wstringToString(projectName) << ".git\n";
-        readmeFile << "cd " << wstringToString(projectName) << "\n";
-        readmeFile << "```\n\n";
-        
-        readmeFile << "## Использование\n\n";
-        readmeFile << "Добавьте примеры использования.\n\n";
-        
-        readmeFile << "## Лицензия\n\n";
-        readmeFile << "Этот проект лицензирован под [MIT License](LICENSE).\n";
-        
+        std::shared_ptr<const TextTemplate> readme = getReadmeTemplate(templateName);
+        if (!readme) {
+            std::wcout << L"Шаблон не найден.\n";
+            return;
+        }
+        std::string descriptionText = wstringToString(description);
+        std::ofstream readmeFile("README.md", std::ios::binary);
+        readmeFile << readme->render({
+            {"name", wstringToString(projectName)},
+            {"description", descriptionText.empty() ? "" : descriptionText + "\n\n"},
+            {"owner", username.empty() ? "username" : wstringToString(username)},
+            {"visibility", ""},
+        });
         readmeFile.close();
         
         std::wcout << L"Файл README.md успешно создан!\n";
@@ -827,8 +7178,7 @@ public:
         std::wcout << L"Файлы добавлены в индекс!\n";
         
         // Показать статус
-        result = executeCommand("git status");
-        std::wcout << stringToWstring(result) << L"\n";
+        printStatusSummary(getWorkingTreeStatus(""));
     }
 
     // Создать коммит
@@ -838,6 +7188,17 @@ public:
             return;
         }
 
+        // Проверяем, есть ли что коммитить
+        WorkingTreeStatus status = getWorkingTreeStatus("");
+        if (status.staged == 0) {
+            std::wcout << L"Нет проиндексированных изменений для коммита.\n";
+            if (!status.isClean()) {
+                printStatusSummary(status);
+                std::wcout << L"Добавьте файлы в индекс (пункт 6 меню).\n";
+            }
+            return;
+        }
+
         std::wstring message;
         std::wcout << L"Введите сообщение коммита: ";
         std::getline(std::wcin, message);
@@ -864,14 +7225,38 @@ public:
         std::getline(std::wcin, branch);
 
         std::string cmd;
-        if (branch.empty()) {
-            cmd = "git push";
+        std::string remote = "origin";
+        std::string localBranch = trimString(wstringToString(branch));
+        std::string remoteBranch = localBranch;
+        if (localBranch.empty()) {
+            cmd = "git push --progress";
+            // Куда отправит git push без аргументов: "<remote>/<ветка>"
+            std::string destination = trimString(executeCommand("git rev-parse --abbrev-ref @{push} 2>nul"));
+            size_t slash = destination.find('/');
+            localBranch = slash == std::string::npos ? "" : trimString(executeCommand("git branch --show-current"));
+            if (!localBranch.empty()) {
+                remote = destination.substr(0, slash);
+                remoteBranch = destination.substr(slash + 1);
+            }
         } else {
-            cmd = "git push origin " + wstringToString(branch);
+            cmd = "git push --progress origin \"" + localBranch + "\"";
         }
 
-        std::string result = executeCommand(cmd);
-        std::wcout << stringToWstring(result) << L"\n";
+        PushCheck check;
+        if (!localBranch.empty() && localBranch.find_first_of(": ") == std::string::npos) {
+            check = checkBranchPush(remote, localBranch, remoteBranch, "");
+            if (check.upToDate()) {
+                std::wcout << L"Ветка '" << stringToWstring(localBranch)
+                          << L"' на удаленном репозитории уже совпадает с локальной, отправка не требуется.\n";
+                return;
+            }
+        }
+
+        startJob(L"Отправка изменений", "", [this, cmd, check, localBranch, remoteBranch](Job& job, const std::string& workDir) {
+            bool succeeded = runJobCommand(job, cmd, workDir) == 0;
+            recordPush(check, localBranch, remoteBranch, succeeded, workDir);
+            return succeeded;
+        });
     }
 
     // Сохранить имя пользователя
@@ -934,56 +7319,828 @@ public:
         std::wcout << L"Текущий email: " << stringToWstring(result);
     }
 
-    // Просмотреть список репозиториев
-    void listRepositories() {
-        if (!isAuthenticated && !authenticate()) return;
+    // Просмотреть список репозиториев
+    void listRepositories() {
+        if (!ensureAuthenticated()) return;
+        
+        std::wcout << L"Введите организацию (пусто - ваши репозитории, 'home' для отмены): ";
+        std::wstring organization;
+        std::getline(std::wcin, organization);
+        
+        if (checkForHomeCommand(organization)) {
+            return;
+        }
+        
+        std::string org = trimString(wstringToString(organization));
+        std::string path = org.empty() ? "/user/repos?per_page=100&sort=full_name" :
+                                         "/orgs/" + org + "/repos?per_page=100&sort=full_name";
+        
+        std::wcout << L"Загрузка списка репозиториев...\n";
+        auto started = std::chrono::steady_clock::now();
+        size_t total = 0;
+        
+        // Строки выводятся постранично по мере получения
+        bool complete = fetchPagedList(path, "repos", [this, &total](const std::string& body) {
+            JsonDocument document(body);
+            document.root().forEach([this](const JsonDocument::Value& repo) {
+                std::wcout << stringToWstring(repo["full_name"].asString()) << L"\t"
+                          << (repo["private"].asBool() ? L"PRIVATE" : L"PUBLIC") << L"\t"
+                          << stringToWstring(repo["description"].asString()) << L"\n";
+            });
+            total += document.root().size();
+        });
+        
+        long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        std::wcout << L"Всего: " << total << L" (" << elapsed << L" мс; страниц загружено: " << pagesFetched
+                  << L", из кэша: " << pagesFromCache << L")\n";
+        if (!complete) {
+            std::wcout << L"Список неполный: часть страниц получить не удалось.\n";
+        }
+    }
+
+    // Клонировать репозиторий
+    void cloneRepository() {
+        if (!ensureAuthenticated()) return;
+        
+        std::wstring repoUrl;
+        std::wcout << L"Введите URL репозитория, имя [username]/[repository] или часть имени для поиска: ";
+        std::getline(std::wcin, repoUrl);
+        
+        // Локальный bare-репозиторий тоже можно клонировать (в том числе через зеркало)
+        std::error_code ec;
+        if (repoUrl.empty() || !std::filesystem::is_directory(repoUrl, ec)) {
+            repoUrl = stringToWstring(selectRepository(repoUrl));
+        }
+        if (repoUrl.empty()) {
+            std::wcout << L"Репозиторий не выбран.\n";
+            return;
+        }
+        
+        std::wstring directory;
+        std::wcout << L"Введите директорию для клонирования (пустое значение для текущей директории): ";
+        std::getline(std::wcin, directory);
+        
+        CloneProfile profile;
+        if (!requestCloneProfile(profile)) {
+            return;
+        }
+        CloneSource source = prepareCloneSource(wstringToString(repoUrl));
+        std::string target = directory.empty() ? MirrorCache::repositoryName(source.url) : wstringToString(directory);
+        std::string mode = getSetting("clone_cache");
+        std::string options = profile.cloneOptions(getIntSetting("checkout_workers", 0));
+        
+        startJob(L"Клонирование " + repoUrl, "", [this, source, target, mode, profile, options](Job& job, const std::string& workDir) {
+            double receivedBytes = 0;
+            return runClone(job, source, target, mode, profile, options, workDir, receivedBytes);
+        });
+    }
+    
+    // Репозиторий для клонирования: имя для gh repo clone и адрес для git
+    struct CloneSource {
+        std::string repository;
+        std::string url;
+    };
+    
+    // Вызывается в потоке меню: определяет адрес и создает каталог зеркал до запуска фоновых потоков
+    CloneSource prepareCloneSource(const std::string& repository) {
+        getMirrorCache();
+        return {repository, resolveCloneUrl(repository)};
+    }
+    
+    // Клонирование в режиме clone_cache: через зеркало либо через gh repo clone (off).
+    // К receivedBytes добавляется объем, полученный из сети
+    bool runClone(Job& job, const CloneSource& source, const std::string& target, const std::string& mode,
+                  const CloneProfile& profile, const std::string& options, const std::string& workDir,
+                  double& receivedBytes) {
+        if (mode == "hardlink" || mode == "reference") {
+            return cloneThroughMirror(job, *mirrorCache, source.url, target, mode == "reference", profile, options,
+                                      workDir, receivedBytes);
+        }
+        std::string sparse = profile.sparseArguments(target);
+        std::filesystem::path gitDir = std::filesystem::path(workDir) / target / ".git";
+        return runTransferJob(job, "gh repo clone " + source.repository + " \"" + target + "\" -- --progress " + options,
+                              gitDir, workDir, receivedBytes) &&
+            (sparse.empty() || runTransferJob(job, "git " + sparse, gitDir, workDir, receivedBytes));
+    }
+    
+    // Объем, выведенный git clone/fetch ("Receiving objects: 100% (..), 1.5 MiB | ..." или "Unpacking objects: ...")
+    static double parseReceivedBytes(const std::string& log) {
+        static const std::vector<std::pair<std::string, double>> units = {
+            {"GiB", 1024.0 * 1024 * 1024}, {"MiB", 1024.0 * 1024}, {"KiB", 1024.0}, {"bytes", 1.0},
+        };
+        double total = 0;
+        for (const std::string marker : {"Receiving objects:", "Unpacking objects:"}) {
+            for (size_t pos = log.find(marker); pos != std::string::npos; pos = log.find(marker, pos + marker.size())) {
+                size_t lineEnd = log.find('\n', pos);
+                std::string line = log.substr(pos, lineEnd == std::string::npos ? std::string::npos : lineEnd - pos);
+                size_t sizeStart = line.find("), ");
+                if (sizeStart == std::string::npos) {
+                    continue;
+                }
+                std::istringstream stream(line.substr(sizeStart + 3));
+                double value = 0;
+                std::string unit;
+                if (stream >> value >> unit) {
+                    for (const auto& known : units) {
+                        if (unit == known.first) {
+                            total += value * known.second;
+                        }
+                    }
+                }
+            }
+        }
+        return total;
+    }
+    
+    // pack-файлы репозитория (служебная директория или bare-репозиторий): имя -> размер
+    static std::map<std::string, uintmax_t> listPackFiles(const std::filesystem::path& gitDir) {
+        std::map<std::string, uintmax_t> packs;
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(gitDir / "objects" / "pack", ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code sizeError;
+            if (it->path().extension() == ".pack") {
+                uintmax_t size = it->file_size(sizeError);
+                if (!sizeError) {
+                    packs[it->path().filename().string()] = size;
+                }
+            }
+        }
+        return packs;
+    }
+    
+    // Команда git clone/fetch в задаче; к receivedBytes добавляется объем полученных данных:
+    // размер новых pack-файлов, а если git распаковал ответ в отдельные объекты - объем,
+    // выведенный самим git (небольшой ответ git распаковывает молча, тогда объем не учитывается)
+    bool runTransferJob(Job& job, const std::string& command, const std::filesystem::path& gitDir,
+                        const std::string& workDir, double& receivedBytes) {
+        size_t logStart = job.getLog().size();
+        std::map<std::string, uintmax_t> before = listPackFiles(gitDir);
+        bool ok = runJobCommand(job, command, workDir) == 0;
+        double packed = 0;
+        for (const auto& pack : listPackFiles(gitDir)) {
+            auto previous = before.find(pack.first);
+            if (previous == before.end() || previous->second != pack.second) {
+                packed += static_cast<double>(pack.second);
+            }
+        }
+        std::string log = job.getLog();
+        receivedBytes += packed > 0 ? packed : parseReceivedBytes(logStart < log.size() ? log.substr(logStart) : "");
+        return ok;
+    }
+    
+    static std::wstring formatBytes(double bytes) {
+        std::wostringstream stream;
+        stream << std::fixed << std::setprecision(1);
+        if (bytes >= 1024.0 * 1024 * 1024) {
+            stream << bytes / (1024.0 * 1024 * 1024) << L" ГиБ";
+        } else if (bytes >= 1024.0 * 1024) {
+            stream << bytes / (1024.0 * 1024) << L" МиБ";
+        } else {
+            stream << bytes / 1024.0 << L" КиБ";
+        }
+        return stream.str();
+    }
+    
+    // Репозитории для массового клонирования: организация (пользователь), файл со списком
+    // или поиск по индексу. Пустой список - ввод отменен или ничего не найдено
+    std::vector<std::string> requestBulkCloneList() {
+        std::wcout << L"Источник списка репозиториев:\n";
+        std::wcout << L"1. Организация или пользователь\n";
+        std::wcout << L"2. Файл со списком (owner/name или URL на строке, # - комментарий)\n";
+        std::wcout << L"3. Поиск по индексу доступных репозиториев\n";
+        std::wcout << L"Ваш выбор: ";
+        std::wstring choice;
+        std::getline(std::wcin, choice);
+        if (checkForHomeCommand(choice)) {
+            return {};
+        }
+        
+        std::vector<std::string> repositories;
+        if (choice == L"1") {
+            std::wcout << L"Имя организации или пользователя: ";
+            std::wstring owner;
+            std::getline(std::wcin, owner);
+            std::string name = trimString(wstringToString(owner));
+            if (name.empty()) {
+                return {};
+            }
+            auto collect = [&repositories](const std::string& body) {
+                JsonDocument document(body);
+                document.root().forEach([&repositories](const JsonDocument::Value& repo) {
+                    if (!repo["archived"].asBool()) {
+                        repositories.push_back(repo["full_name"].asString());
+                    }
+                });
+            };
+            // Тип учетной записи определяет адрес списка; свои репозитории - вместе с приватными
+            HttpResponse account = getApiClient().get("/users/" + name);
+            if (!account.ok()) {
+                printApiError(account, L"Не удалось найти организацию или пользователя");
+                return {};
+            }
+            JsonDocument document(account.body);
+            std::string path = document.root()["type"].asString() == "Organization" ?
+                "/orgs/" + name + "/repos?per_page=100&sort=full_name" :
+                document.root()["login"].asString() == wstringToString(username) ? "/user/repos?affiliation=owner&per_page=100&sort=full_name" :
+                "/users/" + name + "/repos?per_page=100&sort=full_name";
+            std::wcout << L"Загрузка списка репозиториев...\n";
+            bool complete = fetchPagedList(path, "repos", collect);
+            if (!complete) {
+                std::wcout << L"Список неполный: часть страниц получить не удалось.\n";
+            }
+        } else if (choice == L"2") {
+            std::wcout << L"Путь к файлу: ";
+            std::wstring path;
+            std::getline(std::wcin, path);
+            std::ifstream file{std::filesystem::path(path)};
+            if (!file.is_open()) {
+                std::wcout << L"Не удалось открыть файл.\n";
+                return {};
+            }
+            std::string line;
+            while (std::getline(file, line)) {
+                line = trimString(line);
+                if (!line.empty() && line[0] != '#') {
+                    repositories.push_back(line);
+                }
+            }
+        } else if (choice == L"3") {
+            std::wcout << L"Часть имени, описания, темы или языка: ";
+            std::wstring query;
+            std::getline(std::wcin, query);
+            if (!repositoryIndexRefreshed) {
+                refreshRepositoryIndex();
+                repositoryIndexRefreshed = true;
+            }
+            if (!query.empty() && repositoryIndex.isOpen()) {
+                for (uint32_t index : repositoryIndex.search(wstringToString(query), repositoryIndex.size())) {
+                    repositories.push_back(std::string(repositoryIndex.fullName(index)));
+                }
+            }
+        } else {
+            std::wcout << L"Неверный выбор.\n";
+            return {};
+        }
+        
+        if (repositories.empty()) {
+            std::wcout << L"Репозитории не найдены.\n";
+        }
+        return repositories;
+    }
+    
+    // Массовое клонирование с ограничением числа одновременных клонов (clone_concurrency).
+    // Существующие клоны обновляются (git pull --ff-only), для каждого репозитория выводятся
+    // время и объем полученных данных
+    void bulkClone() {
+        if (!ensureAuthenticated()) return;
+        
+        std::vector<std::string> repositories = requestBulkCloneList();
+        if (repositories.empty()) {
+            return;
+        }
+        
+        std::wcout << L"Репозиториев: " << repositories.size() << L". Корневая директория (пусто - текущая): ";
+        std::wstring rootInput;
+        std::getline(std::wcin, rootInput);
+        if (checkForHomeCommand(rootInput)) {
+            return;
+        }
+        std::filesystem::path root = rootInput.empty() ? std::filesystem::current_path() : std::filesystem::path(rootInput);
+        std::error_code ec;
+        std::filesystem::create_directories(root, ec);
+        
+        CloneProfile profile;
+        if (!requestCloneProfile(profile)) {
+            return;
+        }
+        std::string options = profile.cloneOptions(getIntSetting("checkout_workers", 0));
+        std::string mode = getSetting("clone_cache");
+        
+        // Одинаковые имена разных владельцев клонируются в директории owner-name
+        struct Item {
+            CloneSource source;
+            std::string target;
+            bool updated = false;
+            bool ok = false;
+            double seconds = 0;
+            double bytes = 0;
+            std::string error;
+        };
+        std::vector<Item> items;
+        std::map<std::string, int> nameCounts;
+        for (const std::string& repository : repositories) {
+            nameCounts[MirrorCache::repositoryName(repository)]++;
+        }
+        for (const std::string& repository : repositories) {
+            Item item;
+            item.source = prepareCloneSource(repository);
+            std::string name = MirrorCache::repositoryName(repository);
+            std::string owner = MirrorCache::ownerName(repository);
+            if (nameCounts[name] > 1 && !owner.empty()) {
+                name = owner + "-" + name;
+            }
+            item.target = name;
+            items.push_back(std::move(item));
+        }
+        
+        std::atomic<size_t> next{0};
+        std::atomic<int> finished{0};
+        std::mutex outputMutex;
+        CancellationToken cancel = ConsoleInterrupt::beginForeground();
+        std::string workDir = root.string();
+        auto started = std::chrono::steady_clock::now();
+        
+        std::wcout << L"Клонирование в " << root.wstring() << L" (Ctrl-C - остановить)...\n";
+        auto worker = [&]() {
+            for (size_t i = next++; i < items.size() && !cancel.isCancelled(); i = next++) {
+                Item& item = items[i];
+                Job job(static_cast<int>(i + 1), stringToWstring(item.source.repository), item.target, cancel);
+                job.markStarted();
+                std::error_code existsError;
+                std::filesystem::path target = root / item.target;
+                if (std::filesystem::exists(target / ".git", existsError)) {
+                    item.updated = true;
+                    item.ok = runTransferJob(job, "git " + gitCredentialOptions(item.source.url) + "-C \"" +
+                                             item.target + "\" fetch --progress origin",
+                                             WorkspaceIndex::commonGitDirectory(target), workDir, item.bytes) &&
+                        runJobCommand(job, "git -C \"" + item.target + "\" merge --ff-only @{u}", workDir) == 0;
+                } else if (std::filesystem::exists(target, existsError) && !std::filesystem::is_empty(target, existsError)) {
+                    job.appendText("Директория " + item.target + " занята и не является репозиторием Git\n");
+                } else {
+                    item.ok = runClone(job, item.source, item.target, mode, profile, options, workDir, item.bytes);
+                }
+                job.markFinished(item.ok ? Job::State::Succeeded : Job::State::Failed);
+                item.seconds = job.elapsedSeconds();
+                if (!item.ok) {
+                    // Причина - последняя строка "fatal:"/"error:" журнала, иначе последняя строка
+                    std::string log = trimString(job.getLog());
+                    size_t start = std::string::npos;
+                    for (const char* prefix : {"fatal:", "error:"}) {
+                        size_t found = log.rfind(prefix);
+                        if (found != std::string::npos && (start == std::string::npos || found > start)) {
+                            start = found;
+                        }
+                    }
+                    if (start == std::string::npos) {
+                        size_t lastLine = log.find_last_of('\n');
+                        start = lastLine == std::string::npos ? 0 : lastLine + 1;
+                    }
+                    item.error = log.substr(start, log.find('\n', start) - start);
+                }
+                
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::wcout << L"[" << ++finished << L"/" << items.size() << L"] " << stringToWstring(item.source.repository)
+                          << L": " << (item.ok ? (item.updated ? L"обновлен" : L"клонирован") : L"ошибка")
+                          << L", " << formatFixed(item.seconds) << L" с, "
+                          << formatBytes(item.bytes) << L"\n";
+                if (!item.ok && !item.error.empty()) {
+                    std::wcout << L"    " << stringToWstring(item.error) << L"\n";
+                }
+            }
+        };
+        
+        std::vector<std::thread> workers;
+        int workerCount = std::max(1, std::min(getIntSetting("clone_concurrency", 4), static_cast<int>(items.size())));
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+        
+        int cloned = 0, updated = 0, failed = 0;
+        double bytes = 0, sequential = 0;
+        for (const Item& item : items) {
+            (item.ok ? (item.updated ? updated : cloned) : failed)++;
+            bytes += item.bytes;
+            sequential += item.seconds;
+        }
+        int skipped = static_cast<int>(items.size()) - finished;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::wcout << L"\nКлонировано: " << cloned << L", обновлено: " << updated << L", ошибок: " << failed;
+        if (skipped > 0) {
+            std::wcout << L", не обработано: " << skipped;
+        }
+        std::wcout << L"\nПолучено " << formatBytes(bytes) << L" за " << formatFixed(seconds)
+                  << L" с (последовательно " << formatFixed(sequential) << L" с)\n";
+    }
+    
+    // Выбор профиля клонирования; false - ввод отменен
+    bool requestCloneProfile(CloneProfile& profile) {
+        std::wcout << L"Профиль клонирования:\n";
+        std::wcout << L"1. Полная копия (по умолчанию)\n";
+        std::wcout << L"2. Только последний коммит одной ветки (--depth 1)\n";
+        std::wcout << L"3. Вся история без содержимого файлов, файлы загружаются по требованию (blob:none)\n";
+        std::wcout << L"4. Только история коммитов, деревья и файлы по требованию (tree:0)\n";
+        std::wcout << L"5. Только указанные директории (blob:none + sparse-checkout)\n";
+        std::wcout << L"Ваш выбор: ";
+        std::wstring choice;
+        std::getline(std::wcin, choice);
+        if (checkForHomeCommand(choice)) {
+            return false;
+        }
+        
+        int number = choice.empty() ? 1 : static_cast<int>(std::wcstol(choice.c_str(), nullptr, 10));
+        switch (number) {
+            case 1: return true;
+            case 2: profile.depth = 1; profile.singleBranch = true; break;
+            case 3: profile.filter = "blob:none"; break;
+            case 4: profile.filter = "tree:0"; break;
+            case 5: {
+                profile.filter = "blob:none";
+                std::wcout << L"Директории через пробел (например, src/app docs): ";
+                std::wstring paths;
+                std::getline(std::wcin, paths);
+                std::wistringstream stream(paths);
+                std::wstring path;
+                while (stream >> path) {
+                    profile.sparsePaths.push_back(wstringToString(path));
+                }
+                if (profile.sparsePaths.empty()) {
+                    std::wcout << L"Директории не указаны.\n";
+                    return false;
+                }
+                break;
+            }
+            default:
+                std::wcout << L"Неверный выбор.\n";
+                return false;
+        }
+        
+        std::wcout << L"Ветка (пустое значение - ветка по умолчанию): ";
+        std::wstring branch;
+        std::getline(std::wcin, branch);
+        profile.branch = trimString(wstringToString(branch));
+        if (!profile.branch.empty() && number != 2) {
+            profile.singleBranch = true;
+        }
+        return true;
+    }
+
+    MirrorCache& getMirrorCache() {
+        if (!mirrorCache) {
+            mirrorCache = std::make_unique<MirrorCache>(getAppDataDirectory() / "mirrors");
+        }
+        return *mirrorCache;
+    }
+
+    // Адрес для git clone: URL и локальные пути без изменений, owner/name - по протоколу из настроек gh
+    std::string resolveCloneUrl(const std::string& repository) {
+        std::error_code ec;
+        if (repository.find("://") != std::string::npos || repository.rfind("git@", 0) == 0 ||
+            std::filesystem::is_directory(repository, ec)) {
+            return repository;
+        }
+        std::string slug = repository.find('/') == std::string::npos ?
+            wstringToString(username) + "/" + repository : repository;
+        if (gitProtocol.empty()) {
+            gitProtocol = trimString(executeCommand("gh config get git_protocol -h github.com"));
+            gitProtocol = gitProtocol == "ssh" ? gitProtocol : "https";
+        }
+        return gitProtocol == "ssh" ? "git@github.com:" + slug + ".git" : "https://github.com/" + slug + ".git";
+    }
+
+    // Адрес file:// для локального репозитория
+    static std::string fileUrl(const std::filesystem::path& path) {
+        std::string generic = std::filesystem::absolute(path).generic_string();
+        return "file://" + std::string(generic.front() == '/' ? "" : "/") + generic;
+    }
+
+    // Для https://github.com учетные данные git берутся из gh (как при gh repo clone)
+    static std::string gitCredentialOptions(const std::string& url) {
+        if (url.rfind("https://github.com/", 0) != 0) {
+            return "";
+        }
+        return "-c credential.helper= -c \"credential.helper=!gh auth git-credential\" ";
+    }
+
+    // Создание или инкрементальное обновление зеркала; вызывается под блокировкой зеркала.
+    // Зеркало хранит только ветки и теги и никогда не удаляет объекты: на них могут ссылаться
+    // клоны, созданные в режиме reference
+    bool updateMirror(Job& job, const std::string& url, const std::filesystem::path& mirror, const std::string& workDir,
+                      double& receivedBytes) {
+        std::error_code ec;
+        std::string credentials = gitCredentialOptions(url);
+        if (std::filesystem::exists(mirror / "HEAD", ec)) {
+            return runTransferJob(job, "git " + credentials + "-C \"" + mirror.string() +
+                                  "\" fetch --prune --tags --progress origin", mirror, workDir, receivedBytes);
+        }
+
+        std::filesystem::path temporary = mirror;
+        temporary += ".tmp";
+        std::filesystem::remove_all(temporary, ec);
+        std::filesystem::create_directories(mirror.parent_path(), ec);
+        bool created = runTransferJob(job, "git " + credentials + "clone --bare --progress \"" + url + "\" \"" +
+                                      temporary.string() + "\"", temporary, workDir, receivedBytes) &&
+            runJobCommand(job, "git -C \"" + temporary.string() +
+                          "\" config remote.origin.fetch \"+refs/heads/*:refs/heads/*\"", workDir) == 0 &&
+            runJobCommand(job, "git -C \"" + temporary.string() + "\" config gc.pruneExpire never", workDir) == 0 &&
+            runJobCommand(job, "git -C \"" + temporary.string() + "\" config uploadpack.allowFilter true", workDir) == 0;
+        if (created) {
+            std::filesystem::rename(temporary, mirror, ec);
+            created = !ec;
+        }
+        if (!created) {
+            std::filesystem::remove_all(temporary, ec);
+        }
+        return created;
+    }
+
+    // Клонирование через зеркало: по сети передаются только объекты, появившиеся после
+    // предыдущего обновления зеркала. hardlink - локальный клон зеркала (файлы объектов
+    // связываются жесткими ссылками), reference - клон с alternates на зеркало.
+    // Неполный профиль зеркало не создает: если зеркала еще нет, клон берется напрямую
+    // из источника, иначе - из зеркала по file:// (git не применяет --depth и --filter
+    // к клонированию по локальному пути)
+    bool cloneThroughMirror(Job& job, MirrorCache& cache, const std::string& url, const std::string& target,
+                            bool reference, const CloneProfile& profile, const std::string& options,
+                            const std::string& workDir, double& receivedBytes) {
+        std::filesystem::path mirror = cache.pathFor(url);
+        std::string credentials = gitCredentialOptions(url);
+        std::string sparse = profile.sparseArguments(target);
+        bool mirrored = false;
+        {
+            std::unique_lock<std::mutex> lock = cache.lock(mirror);
+            std::error_code ec;
+            if (profile.isFull() || std::filesystem::exists(mirror / "HEAD", ec)) {
+                mirrored = updateMirror(job, url, mirror, workDir, receivedBytes);
+            }
+            if (mirrored && (!reference || !profile.isFull())) {
+                std::string source = profile.isFull() ? mirror.string() : fileUrl(mirror);
+                // Файлы sparse-checkout загружаются из зеркала, до смены origin
+                return runJobCommand(job, "git clone --progress " + options + "\"" + source + "\" \"" + target + "\"", workDir) == 0 &&
+                    (sparse.empty() || runJobCommand(job, "git " + sparse, workDir) == 0) &&
+                    runJobCommand(job, "git -C \"" + target + "\" remote set-url origin \"" + url + "\"", workDir) == 0;
+            }
+        }
+
+        if (!mirrored && profile.isFull()) {
+            job.appendText("Зеркало недоступно, выполняется обычное клонирование\n");
+        }
+        std::string reuse = mirrored ? "--reference-if-able \"" + mirror.string() + "\" " : "";
+        std::error_code ec;
+        std::string source = !profile.isFull() && std::filesystem::is_directory(url, ec) ? fileUrl(url) : url;
+        std::filesystem::path gitDir = std::filesystem::path(workDir) / target / ".git";
+        return runTransferJob(job, "git " + credentials + "clone --progress " + options + reuse + "\"" + source + "\" \"" +
+                              target + "\"", gitDir, workDir, receivedBytes) &&
+            (sparse.empty() || runTransferJob(job, "git " + credentials + sparse, gitDir, workDir, receivedBytes));
+    }
+
+    // Репозитории рабочего пространства: поиск по имени и переход в выбранный репозиторий
+    void showWorkspace() {
+        if (getWorkspaceRoots().empty()) {
+            std::wcout << L"Корневые директории рабочего пространства не заданы (параметр workspace_roots, пункт 30).\n";
+            return;
+        }
         
-        std::wcout << L"Загрузка списка репозиториев...\n";
-        std::string result = executeCommand("gh repo list");
-        std::wcout << stringToWstring(result) << L"\n";
+        bool force = true;
+        while (true) {
+            WorkspaceIndex::RefreshStats stats;
+            auto started = std::chrono::steady_clock::now();
+            WorkspaceIndex& index = getWorkspaceIndex(force, &stats);
+            long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - started).count();
+            if (force) {
+                std::wcout << L"Репозиториев: " << index.getRepositories().size() << L" (" << elapsed << L" мс; директорий: "
+                          << stats.directories << L", из них прочитано: " << stats.listed << L")\n";
+            }
+            force = false;
+            
+            std::wcout << L"Часть имени (пусто - все, 'rescan' - полный повторный обход, 'home' - выход): ";
+            std::wstring query;
+            std::getline(std::wcin, query);
+            if (checkForHomeCommand(query) || std::wcin.eof()) {
+                return;
+            }
+            if (query == L"rescan") {
+                index.invalidate();
+                force = true;
+                continue;
+            }
+            
+            std::vector<const WorkspaceRepository*> matches;
+            if (query.empty()) {
+                for (const WorkspaceRepository& repository : index.getRepositories()) {
+                    matches.push_back(&repository);
+                }
+            } else {
+                matches = index.find(wstringToString(query));
+            }
+            for (size_t i = 0; i < matches.size(); i++) {
+                std::wcout << i + 1 << L". " << stringToWstring(matches[i]->name)
+                          << (matches[i]->kind != "repository" ? L" [" + stringToWstring(matches[i]->kind) + L"]" : L"")
+                          << L"\t" << stringToWstring(matches[i]->path);
+                if (!matches[i]->origin.empty()) {
+                    std::wcout << L"\t" << stringToWstring(matches[i]->origin);
+                }
+                std::wcout << L"\n";
+            }
+            if (matches.empty()) {
+                std::wcout << L"Ничего не найдено.\n";
+                continue;
+            }
+            
+            std::wcout << L"Номер репозитория для перехода (пусто - продолжить поиск): ";
+            std::wstring choice;
+            std::getline(std::wcin, choice);
+            size_t number = std::wcstoul(choice.c_str(), nullptr, 10);
+            if (number >= 1 && number <= matches.size()) {
+                if (!changeWorkingDirectory(matches[number - 1]->path)) {
+                    continue;
+                }
+                return;
+            }
+        }
     }
 
-    // Клонировать репозиторий
-    void cloneRepository() {
-        if (!isAuthenticated && !authenticate()) return;
-        
-        std::wstring repoUrl;
-        std::wcout << L"Введите URL репозитория или имя [username]/[repository]: ";
-        std::getline(std::wcin, repoUrl);
+    // Расчет состояния одного репозитория (вызывается из потоков пула)
+    DashboardEntry computeDashboardEntry(const std::string& path) {
+        std::filesystem::path workTree = std::filesystem::u8path(path);
+        DashboardEntry entry;
+        entry.path = path;
+        entry.computedAt = static_cast<long long>(std::time(nullptr));
+        
+        WorkingTreeStatus status = getWorkingTreeStatus(path);
+        entry.failed = status.branch.empty();
+        entry.branch = std::string(status.branch);
+        entry.upstream = std::string(status.upstream);
+        entry.ahead = status.ahead;
+        entry.behind = status.behind;
+        entry.staged = status.staged;
+        entry.unstaged = status.unstaged;
+        entry.untracked = status.untracked;
+        entry.conflicted = status.conflicted;
+        std::error_code ec;
+        auto fetched = std::filesystem::last_write_time(WorkspaceIndex::gitDirectory(workTree) / "FETCH_HEAD", ec);
+        if (!ec) {
+            entry.lastFetch = entry.computedAt - std::chrono::duration_cast<std::chrono::seconds>(
+                std::filesystem::file_time_type::clock::now() - fetched).count();
+        }
+        
+        // Отпечаток снимается после git status: status сам может обновить index
+        entry.signature = DashboardCache::signature(workTree, &entry);
+        return entry;
+    }
+    
+    // Пересчет устаревших записей сводки в пуле потоков; возвращает число пересчитанных репозиториев
+    size_t updateDashboard(const std::vector<WorkspaceRepository>& repositories, bool force) {
+        std::filesystem::path cachePath = getAppDataDirectory() / "dashboard.cache";
+        if (!dashboardCacheLoaded) {
+            dashboardCache.load(cachePath);
+            dashboardCacheLoaded = true;
+        }
+        dashboardCache.retain(repositories);
+        
+        long long now = static_cast<long long>(std::time(nullptr));
+        long long ttl = std::max(0, getIntSetting("dashboard_ttl", 120));
+        std::vector<const WorkspaceRepository*> stale;
+        for (const WorkspaceRepository& repository : repositories) {
+            const DashboardEntry* cached = dashboardCache.find(repository.path);
+            std::string signature = DashboardCache::signature(std::filesystem::u8path(repository.path), cached);
+            if (force || dashboardCache.findFresh(repository.path, signature, now, ttl) == nullptr) {
+                stale.push_back(&repository);
+            }
+        }
         
-        if (repoUrl.empty()) {
-            std::wcout << L"URL репозитория не может быть пустым!\n";
-            return;
+        // Ссылки, загруженные в фоне, переносятся до расчета: "вперед/назад" без ожидания fetch
+        for (const WorkspaceRepository& repository : repositories) {
+            if (applyPrefetchedRefs(repository.path)) {
+                invalidateRefIndex(repository.path);
+                if (std::find(stale.begin(), stale.end(), &repository) == stale.end()) {
+                    stale.push_back(&repository);
+                }
+            }
+        }
+        if (stale.empty()) {
+            return 0;
         }
         
-        std::wstring directory;
-        std::wcout << L"Введите директорию для клонирования (пустое значение для текущей директории): ";
-        std::getline(std::wcin, directory);
+        getStatusAccelerationArgs(); // Определяется один раз до запуска потоков
+        std::vector<DashboardEntry> results(stale.size());
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        auto worker = [&]() {
+            for (size_t i = next++; i < stale.size(); i = next++) {
+                results[i] = computeDashboardEntry(stale[i]->path);
+                done++;
+            }
+        };
+        std::vector<std::thread> workers;
+        unsigned threadCount = std::min(8u, std::max(2u, std::thread::hardware_concurrency()));
+        for (unsigned i = 0; i < threadCount && i < stale.size(); i++) {
+            workers.emplace_back(worker);
+        }
+        while (done < stale.size()) {
+            std::wcout << L"\rОбновление состояния: " << done << L"/" << stale.size() << std::flush;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        std::wcout << L"\r";
+        for (auto& thread : workers) {
+            thread.join();
+        }
         
-        std::string cmd = "gh repo clone " + wstringToString(repoUrl);
-        if (!directory.empty()) {
-            cmd += " " + wstringToString(directory);
+        for (DashboardEntry& entry : results) {
+            dashboardCache.store(std::move(entry));
+        }
+        dashboardCache.save(cachePath);
+        return stale.size();
+    }
+    
+    // Сводка состояния всех репозиториев рабочего пространства
+    void showDashboard() {
+        if (getWorkspaceRoots().empty()) {
+            std::wcout << L"Корневые директории рабочего пространства не заданы (параметр workspace_roots, пункт 30).\n";
+            return;
         }
         
-        std::string result = executeCommand(cmd);
-        std::wcout << stringToWstring(result) << L"\n";
-        std::wcout << L"Репозиторий успешно клонирован!\n";
+        bool force = false;
+        bool attentionOnly = false;
+        while (true) {
+            auto started = std::chrono::steady_clock::now();
+            const std::vector<WorkspaceRepository>& repositories = getWorkspaceIndex().getRepositories();
+            size_t recomputed = updateDashboard(repositories, force);
+            force = false;
+            long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - started).count();
+            
+            std::vector<std::pair<const WorkspaceRepository*, const DashboardEntry*>> rows;
+            size_t dirty = 0, unpushed = 0, behind = 0;
+            for (const WorkspaceRepository& repository : repositories) {
+                const DashboardEntry* entry = dashboardCache.find(repository.path);
+                if (entry == nullptr) {
+                    continue;
+                }
+                bool attention = entry->failed || entry->isDirty() || entry->ahead > 0 || entry->behind > 0;
+                dirty += entry->isDirty() ? 1 : 0;
+                unpushed += entry->ahead > 0 ? 1 : 0;
+                behind += entry->behind > 0 ? 1 : 0;
+                if (!attentionOnly || attention) {
+                    rows.emplace_back(&repository, entry);
+                }
+            }
+            
+            std::wcout << std::left << std::setw(5) << L"#" << std::setw(28) << L"Репозиторий" << std::setw(24) << L"Ветка"
+                      << std::setw(22) << L"Изменения" << std::setw(14) << L"Вперед/назад" << L"Fetch\n";
+            for (size_t i = 0; i < rows.size(); i++) {
+                const DashboardEntry& entry = *rows[i].second;
+                std::wstring changes = L"-";
+                if (entry.failed) {
+                    changes = L"ошибка git";
+                } else if (entry.isDirty()) {
+                    changes = L"+" + std::to_wstring(entry.staged) + L" ~" + std::to_wstring(entry.unstaged) +
+                              L" ?" + std::to_wstring(entry.untracked) +
+                              (entry.conflicted > 0 ? L" !" + std::to_wstring(entry.conflicted) : L"");
+                }
+                std::wstring sync = entry.upstream.empty() ? L"нет" :
+                    std::to_wstring(entry.ahead) + L" / " + std::to_wstring(entry.behind);
+                std::wcout << std::setw(5) << i + 1 << std::setw(28) << stringToWstring(rows[i].first->name).substr(0, 27)
+                          << std::setw(24) << stringToWstring(entry.branch).substr(0, 23) << std::setw(22) << changes
+                          << std::setw(14) << sync << (entry.lastFetch > 0 ? formatAge(entry.lastFetch) : L"-") << L"\n";
+            }
+            std::wcout << std::right;
+            std::wcout << L"Репозиториев: " << repositories.size() << L"; с изменениями: " << dirty << L", с неотправленными коммитами: "
+                      << unpushed << L", отстают от upstream: " << behind << L" (" << elapsed << L" мс, пересчитано: "
+                      << recomputed << L")\n";
+            
+            std::wcout << L"Enter - обновить, 'all' - пересчитать все, 'filter' - " << (attentionOnly ? L"показать все" : L"только требующие внимания")
+                      << L", номер - перейти в репозиторий, 'home' - выход: ";
+            std::wstring input;
+            std::getline(std::wcin, input);
+            if (checkForHomeCommand(input) || std::wcin.eof()) {
+                return;
+            }
+            if (input == L"all") {
+                force = true;
+            } else if (input == L"filter") {
+                attentionOnly = !attentionOnly;
+            } else if (!input.empty()) {
+                size_t number = std::wcstoul(input.c_str(), nullptr, 10);
+                if (number >= 1 && number <= rows.size()) {
+                    if (changeWorkingDirectory(rows[number - 1].first->path)) {
+                        return;
+                    }
+                }
+            }
+        }
     }
 
     // Удалить репозиторий
     void deleteRepository() {
-        if (!isAuthenticated && !authenticate()) return;
+        if (!ensureAuthenticated()) return;
         
         std::wstring repoName;
-        std::wcout << L"Введите имя репозитория для удаления: ";
+        std::wcout << L"Введите имя репозитория для удаления (или часть имени для поиска): ";
         std::getline(std::wcin, repoName);
         
-        if (repoName.empty()) {
-            std::wcout << L"Имя репозитория не может быть пустым!\n";
+        // Удаляется только найденный репозиторий, и подтверждается его полное имя
+        std::string slug = selectRepository(repoName, false);
+        if (slug.empty()) {
+            std::wcout << L"Репозиторий не найден, удаление отменено.\n";
             return;
         }
         
-        std::wcout << L"ВНИМАНИЕ: Удаление репозитория необратимо!\n";
+        std::wcout << L"ВНИМАНИЕ: Удаление репозитория " << stringToWstring(slug) << L" необратимо!\n";
         std::wcout << L"Введите 'YES' для подтверждения удаления: ";
         std::wstring confirmation;
         std::getline(std::wcin, confirmation);
@@ -993,21 +8150,26 @@ public:
             return;
         }
         
-        std::string cmd;
-        if (repoName.find(L'/') == std::wstring::npos && !username.empty()) {
-            cmd = "gh repo delete " + wstringToString(username) + "/" + wstringToString(repoName) + " --yes";
-        } else {
-            cmd = "gh repo delete " + wstringToString(repoName) + " --yes";
+        if (!hasTokenScope("delete_repo")) {
+            std::wcout << L"У токена нет доступа delete_repo: gh auth refresh -h github.com -s delete_repo\n";
+            return;
         }
         
-        std::string result = executeCommand(cmd);
-        std::wcout << stringToWstring(result) << L"\n";
+        HttpResponse response = getApiClient().del("/repos/" + slug);
+        if (!response.ok()) {
+            printApiError(response, L"Не удалось удалить репозиторий");
+            if (response.status == 403) {
+                std::wcout << L"Для удаления нужен доступ delete_repo: gh auth refresh -h github.com -s delete_repo\n";
+            }
+            return;
+        }
+        removeFromRepositoryIndex(slug);
         std::wcout << L"Репозиторий успешно удален!\n";
     }
 
     // Создать issue
     void createIssue() {
-        if (!isAuthenticated && !authenticate()) return;
+        if (!ensureAuthenticated()) return;
         
         if (!isGitRepository()) {
             std::wcout << L"Текущая директория не является Git репозиторием.\n";
@@ -1031,16 +8193,413 @@ public:
             body += line + L"\n";
         }
         
-        std::string cmd = "gh issue create --title \"" + wstringToString(title) + "\"";
+        std::string slug = getOriginSlug();
+        if (slug.empty()) {
+            std::wcout << L"Удаленный репозиторий origin не указывает на GitHub.\n";
+            return;
+        }
+        
+        std::string requestBody = "{\"title\":\"" + JsonDocument::escape(wstringToString(title)) + "\"";
         if (!body.empty()) {
-            cmd += " --body \"" + wstringToString(body) + "\"";
+            requestBody += ",\"body\":\"" + JsonDocument::escape(wstringToString(body)) + "\"";
         }
+        requestBody += "}";
         
-        std::string result = executeCommand(cmd);
-        std::wcout << stringToWstring(result) << L"\n";
+        HttpResponse response = getApiClient().post("/repos/" + slug + "/issues", requestBody);
+        if (!response.ok()) {
+            printApiError(response, L"Не удалось создать задачу");
+            return;
+        }
+        
+        JsonDocument document(response.body);
+        std::wcout << stringToWstring(document.root()["html_url"].asString()) << L"\n";
         std::wcout << L"Задача успешно создана!\n";
     }
     
+    // Запрос репозитория GitHub ("владелец/имя" или адрес); по умолчанию - origin текущего репозитория.
+    // Пустая строка - отмена
+    std::string requestRepositorySlug() {
+        std::string slug = isGitRepository() ? getOriginSlug() : "";
+        std::wcout << L"Репозиторий (владелец/имя)";
+        if (!slug.empty()) {
+            std::wcout << L" [" << stringToWstring(slug) << L"]";
+        }
+        std::wcout << L": ";
+        std::wstring input;
+        std::getline(std::wcin, input);
+        if (checkForHomeCommand(input)) {
+            return "";
+        }
+        std::string entered = trimString(wstringToString(input));
+        if (!entered.empty()) {
+            // Принимается и "владелец/имя", и адрес репозитория
+            slug = entered.find("github.com") != std::string::npos ? parseGitHubSlug(entered) :
+                   std::count(entered.begin(), entered.end(), '/') == 1 ? entered : "";
+        }
+        if (slug.empty()) {
+            std::wcout << L"Репозиторий не указан.\n";
+        }
+        return slug;
+    }
+    
+    // Номера вех репозитория по названию
+    std::map<std::string, long long> loadMilestones(const std::string& slug) {
+        std::map<std::string, long long> milestones;
+        for (int page = 1;; page++) {
+            HttpResponse response = getApiClient().get("/repos/" + slug + "/milestones?state=all&per_page=100&page=" +
+                                                       std::to_string(page));
+            if (!response.ok()) {
+                break;
+            }
+            JsonDocument document(response.body);
+            document.root().forEach([&milestones](const JsonDocument::Value& item) {
+                milestones[item["title"].asString()] = item["number"].asInt();
+            });
+            if (document.root().size() < 100) {
+                break;
+            }
+        }
+        return milestones;
+    }
+    
+    // Массовый импорт задач из CSV/JSON. Записи читаются из файла по мере создания задач,
+    // задачи создаются параллельно (частоту запросов ограничивает планировщик API),
+    // созданные записи отмечаются в журнале. Ctrl-C останавливает импорт после текущих запросов
+    void importIssues() {
+        if (!ensureAuthenticated()) return;
+        
+        std::string slug = requestRepositorySlug();
+        if (slug.empty()) {
+            return;
+        }
+        
+        std::wstring input;
+        std::wcout << L"Путь к файлу CSV или JSON: ";
+        std::getline(std::wcin, input);
+        if (checkForHomeCommand(input)) {
+            return;
+        }
+        std::string fileName = trimString(wstringToString(input));
+        if (fileName.size() >= 2 && fileName.front() == '"' && fileName.back() == '"') {
+            fileName = fileName.substr(1, fileName.size() - 2);
+        }
+        std::error_code ec;
+        std::filesystem::path filePath = std::filesystem::absolute(fileName, ec);
+        IssueImportReader reader(filePath);
+        if (fileName.empty() || !reader.isOpen()) {
+            std::wcout << L"Не удалось открыть файл.\n";
+            return;
+        }
+        
+        ImportJournal journal(getAppDataDirectory() / "imports" /
+            ("issues-" + std::to_string(std::hash<std::string>()(slug + "|" + filePath.string())) + ".journal"));
+        if (journal.size() > 0) {
+            std::wcout << L"Найден журнал предыдущего импорта этого файла: создано задач - " << journal.size()
+                      << L". Продолжить с места остановки? (д/н): ";
+            std::getline(std::wcin, input);
+            if (input == L"н" || input == L"Н") {
+                journal.clear();
+            }
+        }
+        
+        std::map<std::string, long long> milestones = loadMilestones(slug);
+        std::mutex milestoneMutex;
+        // Номер вехи по названию; отсутствующая веха создается один раз
+        auto resolveMilestone = [&](const std::string& title) -> long long {
+            std::lock_guard<std::mutex> lock(milestoneMutex);
+            auto it = milestones.find(title);
+            if (it != milestones.end()) {
+                return it->second;
+            }
+            HttpResponse response = getApiClient().post("/repos/" + slug + "/milestones",
+                                                         "{\"title\":\"" + JsonDocument::escape(title) + "\"}");
+            long long number = response.ok() ? JsonDocument(response.body).root()["number"].asInt() : 0;
+            milestones[title] = number;
+            return number;
+        };
+        
+        std::mutex readerMutex;
+        std::map<std::string, size_t> occurrences; // Одинаковые записи различаются номером повторения
+        std::mutex outputMutex;
+        std::atomic<int> created{0};
+        std::atomic<int> skipped{0};
+        std::atomic<int> failed{0};
+        CancellationToken cancel = ConsoleInterrupt::beginForeground();
+        auto started = std::chrono::steady_clock::now();
+        
+        std::wcout << L"Импорт задач в " << stringToWstring(slug) << L" (Ctrl-C - остановить)...\n";
+        auto worker = [&]() {
+            while (!cancel.isCancelled()) {
+                IssueRecord record;
+                std::string error;
+                std::string key;
+                {
+                    std::lock_guard<std::mutex> lock(readerMutex);
+                    if (!reader.next(record, error)) {
+                        return;
+                    }
+                    key = ImportJournal::key(record.title, record.body, 0);
+                    key = ImportJournal::key(record.title, record.body, occurrences[key]++);
+                }
+                if (journal.contains(key)) {
+                    skipped++;
+                    continue;
+                }
+                if (!error.empty()) {
+                    failed++;
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    std::wcout << L"[" << record.index << L"] " << stringToWstring(error) << L"\n";
+                    continue;
+                }
+                
+                std::string requestBody = "{\"title\":\"" + JsonDocument::escape(record.title) + "\"";
+                if (!record.body.empty()) {
+                    requestBody += ",\"body\":\"" + JsonDocument::escape(record.body) + "\"";
+                }
+                for (const auto& list : {std::make_pair("labels", &record.labels),
+                                         std::make_pair("assignees", &record.assignees)}) {
+                    if (list.second->empty()) {
+                        continue;
+                    }
+                    requestBody += ",\"" + std::string(list.first) + "\":[";
+                    for (size_t i = 0; i < list.second->size(); i++) {
+                        requestBody += (i > 0 ? ",\"" : "\"") + JsonDocument::escape((*list.second)[i]) + "\"";
+                    }
+                    requestBody += "]";
+                }
+                if (!record.milestone.empty()) {
+                    long long milestone = resolveMilestone(record.milestone);
+                    if (milestone > 0) {
+                        requestBody += ",\"milestone\":" + std::to_string(milestone);
+                    }
+                }
+                requestBody += "}";
+                
+                HttpResponse response = getApiClient().post("/repos/" + slug + "/issues", requestBody);
+                std::lock_guard<std::mutex> lock(outputMutex);
+                if (!response.ok()) {
+                    failed++;
+                    std::wcout << L"[" << record.index << L"] " << stringToWstring(record.title) << L": ";
+                    printApiError(response, L"не создана");
+                    continue;
+                }
+                long long number = JsonDocument(response.body).root()["number"].asInt();
+                journal.record(key, number);
+                created++;
+                std::wcout << L"[" << record.index << L"] #" << number << L" " << stringToWstring(record.title) << L"\n";
+            }
+        };
+        
+        std::vector<std::thread> workers;
+        int workerCount = std::max(1, getIntSetting("api_concurrency", 6));
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+        
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::wcout << L"\nСоздано задач: " << created << L", уже были созданы ранее: " << skipped
+                  << L", ошибок: " << failed << L" (" << formatFixed(seconds) << L" с)\n";
+        if (cancel.isCancelled()) {
+            std::wcout << L"Импорт остановлен. Повторный запуск с тем же файлом продолжит с места остановки.\n";
+        } else if (failed > 0) {
+            std::wcout << L"Исправьте записи с ошибками и запустите импорт повторно: созданные задачи будут пропущены.\n";
+        }
+    }
+    
+    // Запись локальной копии из объекта задачи REST API
+    static IssueItem parseIssueItem(const JsonDocument::Value& value) {
+        IssueItem item;
+        item.number = value["number"].asInt();
+        item.pullRequest = value["pull_request"].exists() && !value["pull_request"].isNull();
+        item.open = value["state"].asString() == "open";
+        item.updatedAt = parseIsoTime(value["updated_at"].asString());
+        item.comments = value["comments"].asInt();
+        item.title = value["title"].asString();
+        item.author = value["user"]["login"].asString();
+        item.milestone = value["milestone"]["title"].asString();
+        item.body = value["body"].asString();
+        value["labels"].forEach([&item](const JsonDocument::Value& label) {
+            item.labels.push_back(label["name"].asString());
+        });
+        value["assignees"].forEach([&item](const JsonDocument::Value& assignee) {
+            item.assignees.push_back(assignee["login"].asString());
+        });
+        return item;
+    }
+    
+    std::filesystem::path getIssueStorePath(const std::string& slug) {
+        return getAppDataDirectory() / "issues" / ("issues-" + std::to_string(std::hash<std::string>()(
+            getApiClient().getBaseUrl() + "|" + slug)) + ".db");
+    }
+    
+    // Синхронизация локальной копии задач. Полная загрузка выполняется при отсутствии копии и раз
+    // в сутки (удаленные и перенесенные задачи); иначе запрашиваются только записи, измененные
+    // после курсора (since). Возвращает число полученных записей или -1 при ошибке
+    long long syncIssues(IssueStore& store, const std::string& slug, bool forceFull) {
+        long long now = static_cast<long long>(std::time(nullptr));
+        bool full = forceFull || store.cursor.empty() || now - store.fullSyncAt > 24 * 60 * 60;
+        const std::string path = "/repos/" + slug + "/issues?state=all&sort=updated&direction=asc&per_page=100";
+        std::string cursor = store.cursor;
+        long long received = 0;
+        
+        auto updateCursor = [&cursor](const JsonDocument::Value& value) {
+            std::string updated = value["updated_at"].asString();
+            if (updated > cursor) {
+                cursor = updated; // ISO 8601 в UTC сравнивается как строка
+            }
+        };
+        
+        if (full) {
+            std::vector<IssueItem> items;
+            bool complete = fetchPagedList(path, "issues", [&](const std::string& body) {
+                JsonDocument(body).root().forEach([&](const JsonDocument::Value& value) {
+                    items.push_back(parseIssueItem(value));
+                    updateCursor(value);
+                });
+            });
+            if (!complete) {
+                return -1;
+            }
+            received = static_cast<long long>(items.size());
+            store.replaceAll(std::move(items));
+            store.fullSyncAt = now;
+        } else {
+            for (int page = 1;; page++) {
+                HttpResponse response = getApiClient().get(path + "&since=" + store.cursor + "&page=" + std::to_string(page));
+                JsonDocument document(response.body);
+                if (!response.ok() || !document.root().isArray()) {
+                    printApiError(response, L"Не удалось синхронизировать задачи");
+                    return -1;
+                }
+                document.root().forEach([&](const JsonDocument::Value& value) {
+                    store.upsert(parseIssueItem(value));
+                    updateCursor(value);
+                    received++;
+                });
+                if (document.root().size() < 100) {
+                    break;
+                }
+            }
+        }
+        
+        store.cursor = cursor;
+        store.save(getIssueStorePath(slug));
+        return received;
+    }
+    
+    // Разбор строки фильтра: open/closed/all, issue/pr, label:, assignee:, author:, остальное - текст
+    static IssueFilter parseIssueFilter(const std::string& line) {
+        IssueFilter filter;
+        std::istringstream stream(line);
+        std::string word;
+        while (stream >> word) {
+            if (word == "open" || word == "closed" || word == "all") {
+                filter.state = word;
+            } else if (word == "issue" || word == "pr") {
+                filter.kind = word;
+            } else if (word.rfind("label:", 0) == 0) {
+                filter.label = word.substr(6);
+            } else if (word.rfind("assignee:", 0) == 0) {
+                filter.assignee = word.substr(9);
+            } else if (word.rfind("author:", 0) == 0) {
+                filter.author = word.substr(7);
+            } else {
+                filter.text += (filter.text.empty() ? "" : " ") + word;
+            }
+        }
+        return filter;
+    }
+    
+    // Просмотр задач и pull request по локальной копии: синхронизация изменений при входе,
+    // затем отбор без обращения к сети
+    void browseIssues() {
+        if (!ensureAuthenticated()) return;
+        
+        std::string slug = requestRepositorySlug();
+        if (slug.empty()) {
+            return;
+        }
+        
+        IssueStore store;
+        store.load(getIssueStorePath(slug));
+        auto started = std::chrono::steady_clock::now();
+        long long received = syncIssues(store, slug, false);
+        if (received >= 0) {
+            std::wcout << L"Синхронизировано: получено записей - " << received << L", всего в копии - " << store.size()
+                      << L" (" << std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - started).count() << L" мс)\n";
+        } else if (store.size() > 0) {
+            std::wcout << L"Используется сохраненная копия (" << store.size() << L" записей).\n";
+        }
+        
+        const size_t displayLimit = 50;
+        while (true) {
+            std::wcout << L"\nФильтр (open/closed/all, issue/pr, label:X, assignee:X, author:X, текст),\n"
+                      << L"номер - подробности, sync - синхронизация, full - полная загрузка, пусто - выход: ";
+            std::wstring input;
+            std::getline(std::wcin, input);
+            if (checkForHomeCommand(input)) {
+                return;
+            }
+            std::string line = trimString(wstringToString(input));
+            if (line.empty()) {
+                return;
+            }
+            if (line == "sync" || line == "full") {
+                received = syncIssues(store, slug, line == "full");
+                if (received >= 0) {
+                    std::wcout << L"Получено записей: " << received << L", всего: " << store.size() << L"\n";
+                }
+                continue;
+            }
+            
+            std::string number = line[0] == '#' ? line.substr(1) : line;
+            if (!number.empty() && std::all_of(number.begin(), number.end(), [](char c) {
+                    return std::isdigit(static_cast<unsigned char>(c)) != 0;
+                })) {
+                const IssueItem* item = store.find(std::stoll(number));
+                if (item == nullptr) {
+                    std::wcout << L"Запись #" << stringToWstring(number) << L" не найдена.\n";
+                    continue;
+                }
+                std::wcout << L"#" << item->number << L" " << stringToWstring(item->title) << L"\n"
+                          << (item->pullRequest ? L"Pull request" : L"Задача") << L", "
+                          << (item->open ? L"открыт(а)" : L"закрыт(а)") << L", автор: " << stringToWstring(item->author)
+                          << L", комментариев: " << item->comments << L"\n";
+                if (!item->milestone.empty()) {
+                    std::wcout << L"Веха: " << stringToWstring(item->milestone) << L"\n";
+                }
+                std::wcout << L"https://github.com/" << stringToWstring(slug) << (item->pullRequest ? L"/pull/" : L"/issues/")
+                          << item->number << L"\n\n" << stringToWstring(item->body) << L"\n";
+                continue;
+            }
+            
+            auto queryStarted = std::chrono::steady_clock::now();
+            std::vector<const IssueItem*> matches = store.query(parseIssueFilter(line));
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - queryStarted).count();
+            for (size_t i = 0; i < matches.size() && i < displayLimit; i++) {
+                const IssueItem* item = matches[i];
+                std::wcout << L"#" << item->number << (item->pullRequest ? L" [PR]" : L"")
+                          << (item->open ? L"" : L" [закрыт]") << L" " << stringToWstring(item->title);
+                for (const auto& label : item->labels) {
+                    std::wcout << L" [" << stringToWstring(label) << L"]";
+                }
+                for (const auto& assignee : item->assignees) {
+                    std::wcout << L" @" << stringToWstring(assignee);
+                }
+                std::wcout << L"\n";
+            }
+            if (matches.size() > displayLimit) {
+                std::wcout << L"... и еще " << matches.size() - displayLimit << L"\n";
+            }
+            std::wcout << L"Найдено: " << matches.size() << L" (" << formatFixed(elapsed / 1000.0, 2) << L" мс)\n";
+        }
+    }
+    
     // Создать файл .gitignore
     void createGitignore() {
         std::wcout << L"Выберите тип проекта для .gitignore:\n";
@@ -1049,6 +8608,7 @@ public:
         std::wcout << L"3. JavaScript/Node.js\n";
         std::wcout << L"4. Java\n";
         std::wcout << L"5. Пользовательский\n";
+        std::wcout << L"6. Другой шаблон GitHub (поиск по имени)\n";
         std::wcout << L"Ваш выбор: ";
         
         int choice;
@@ -1057,33 +8617,67 @@ public:
         
         std::string templateName;
         switch (choice) {
-            case 1: templateName = "c++"; break;
-            case 2: templateName = "python"; break;
-            case 3: templateName = "node"; break;
-            case 4: templateName = "java"; break;
+            case 1: templateName = "C++"; break;
+            case 2: templateName = "Python"; break;
+            case 3: templateName = "Node"; break;
+            case 4: templateName = "Java"; break;
             case 5: 
                 createCustomGitignore();
                 return;
+            case 6:
+                templateName = pickGitignoreTemplate();
+                if (templateName.empty()) {
+                    return;
+                }
+                break;
             default:
                 std::wcout << L"Неверный выбор.\n";
                 return;
         }
         
-        std::string cmd = "gh gitignore list";
-        std::string result = executeCommand(cmd);
-        
-        if (result.find(templateName) == std::string::npos) {
-            templateName = templateName == "c++" ? "C++" : 
-                          (templateName == "python" ? "Python" : 
-                          (templateName == "node" ? "Node" : "Java"));
+        // Шаблоны берутся из локального хранилища
+        const std::string* text = getGitignoreTemplates().find(templateName);
+        if (text == nullptr) {
+            std::wcout << L"Шаблон " << stringToWstring(templateName)
+                      << L" недоступен: нет локальной копии шаблонов и соединения с GitHub.\n";
+            return;
         }
         
-        cmd = "gh gitignore " + templateName + " > .gitignore";
-        executeCommand(cmd);
+        std::ofstream file(".gitignore", std::ios::binary);
+        file << *text;
+        file.close();
         
         std::wcout << L"Файл .gitignore создан для " << stringToWstring(templateName) << L"!\n";
     }
     
+    // Выбор шаблона .gitignore по части имени; пустая строка - отмена
+    std::string pickGitignoreTemplate() {
+        std::wcout << L"Часть имени шаблона (например, Go, Unity, Visual): ";
+        std::wstring query;
+        std::getline(std::wcin, query);
+        if (checkForHomeCommand(query) || query.empty()) {
+            return "";
+        }
+        
+        std::vector<std::string> names = getGitignoreTemplates().search(wstringToString(query));
+        if (names.empty()) {
+            std::wcout << L"Шаблоны не найдены.\n";
+            return "";
+        }
+        if (names.size() == 1) {
+            return names[0];
+        }
+        const size_t limit = 30;
+        for (size_t i = 0; i < names.size() && i < limit; i++) {
+            std::wcout << i + 1 << L". " << stringToWstring(names[i]) << L"\n";
+        }
+        std::wcout << L"Номер шаблона: ";
+        std::wstring choice;
+        std::getline(std::wcin, choice);
+        size_t number = std::wcstoul(choice.c_str(), nullptr, 10);
+        return number >= 1 && number <= std::min(limit, names.size()) ? names[number - 1] : "";
+    }
+    
     // Создать пользовательский файл .gitignore
     void createCustomGitignore() {
         std::wcout << L"Введите шаблоны для игнорирования (по одному на строку, пустая строка для завершения):\n";
@@ -1167,16 +8761,7 @@ public:
         }
         
         // Проверяем, есть ли коммиты в репозитории
-        std::string revParseCmd = "git rev-parse --verify HEAD 2>nul";
-        std::string revParseResult;
-        
-        if (workDir.empty()) {
-            revParseResult = executeCommand(revParseCmd);
-        } else {
-            revParseResult = executeCommandInDirectory(revParseCmd, workDir);
-        }
-        
-        if (revParseResult.empty() || revParseResult.find("fatal") != std::string::npos) {
+        if (!hasCommits(workDir)) {
             // В репозитории нет коммитов
             std::wcout << L"В репозитории пока нет веток. Необходимо сделать первый коммит.\n";
             std::wcout << L"Хотите создать первый коммит? (д/н): ";
@@ -1220,6 +8805,9 @@ public:
         std::wcout << stringToWstring(result) << L"\n";
         
         std::wcout << L"Удаленные ветки:\n";
+        if (applyPrefetchedRefs(workDir)) {
+            invalidateRefIndex(workDir);
+        }
         if (workDir.empty()) {
             result = executeCommand("git branch -r");
         } else {
@@ -1252,16 +8840,7 @@ public:
         }
         
         // Проверяем, настроен ли удаленный репозиторий
-        std::string remoteCmd = "git remote -v";
-        std::string remoteResult;
-        
-        if (workDir.empty()) {
-            remoteResult = executeCommand(remoteCmd);
-        } else {
-            remoteResult = executeCommandInDirectory(remoteCmd, workDir);
-        }
-        
-        if (remoteResult.empty() || remoteResult.find("origin") == std::string::npos) {
+        if (!hasRemote("origin", workDir)) {
             // Удаленный репозиторий не настроен
             std::wcout << L"Удаленный репозиторий не настроен. Хотите создать репозиторий на GitHub? (д/н): ";
             wchar_t createRepoChoice;
@@ -1297,31 +8876,20 @@ public:
                 
                 bool isPrivate = (privateChoice == L'д' || privateChoice == L'Д');
                 
-                // Формируем команду для создания репозитория
-                std::string createRepoCmd = "gh repo create " + wstringToString(repoName) + 
-                                          " --" + (isPrivate ? "private" : "public");
+                HttpResponse createResponse = createRemoteRepository(repoName, isPrivate);
                 
-                std::string result;
-                result = executeCommand(createRepoCmd);
-                std::wcout << stringToWstring(result) << L"\n";
-                
-                if (result.find("https://github.com/") != std::string::npos || 
-                    result.find("Created repository") != std::string::npos) {
+                if (createResponse.ok()) {
                     std::wcout << L"Репозиторий успешно создан на GitHub!\n";
                     
                     // Связываем локальный и удаленный репозитории
-                    std::string remoteAddCmd = "git remote add origin https://github.com/" + 
-                                             wstringToString(username) + "/" + wstringToString(repoName) + ".git";
-                    
-                    if (workDir.empty()) {
-                        result = executeCommand(remoteAddCmd);
-                    } else {
-                        result = executeCommandInDirectory(remoteAddCmd, workDir);
-                    }
+                    JsonDocument document(createResponse.body);
+                    std::string remoteAddCmd = "git remote add origin " + document.root()["clone_url"].asString();
                     
+                    executeCommandInWorkDir(remoteAddCmd, workDir);
                     std::wcout << L"Локальный репозиторий связан с удаленным!\n";
                 } else {
-                    std::wcout << L"Не удалось создать репозиторий на GitHub. Продолжаем без связывания с удаленным репозиторием.\n";
+                    printApiError(createResponse, L"Не удалось создать репозиторий на GitHub");
+                    std::wcout << L"Продолжаем без связывания с удаленным репозиторием.\n";
                 }
             }
         }
@@ -1348,6 +8916,8 @@ public:
             result = executeCommandInDirectory(cmd, workDir);
         }
         
+        invalidateRefIndex(workDir);
+        
         if (result.empty()) {
             std::wcout << L"Ветка '" << branchName << L"' успешно создана!\n";
             
@@ -1402,25 +8972,26 @@ public:
             }
         }
         
-        std::string branches;
-        if (workDir.empty()) {
-            branches = executeCommand("git branch");
-        } else {
-            branches = executeCommandInDirectory("git branch", workDir);
-        }
-        
-        std::wcout << L"Доступные ветки:\n" << stringToWstring(branches) << L"\n";
+        bool isRemoteBranch = false;
+        std::wstring branchName = pickBranch(workDir, L"Выберите ветку для переключения", true, &isRemoteBranch);
         
-        std::wstring branchName;
-        std::wcout << L"Введите имя ветки для переключения (или 'home' для возврата в меню): ";
-        std::getline(std::wcin, branchName);
+        if (branchName.empty()) {
+            return; // Пользователь отменил выбор
+        }
         
-        if (checkForHomeCommand(branchName)) {
-            return;
+        // Для удаленной ветки переключаемся по короткому имени: git создаст локальную ветку с отслеживанием
+        if (isRemoteBranch) {
+            branchName = branchName.substr(branchName.find(L'/') + 1);
         }
         
-        if (branchName.empty()) {
-            std::wcout << L"Имя ветки не может быть пустым!\n";
+        // В режиме пула рабочих копий не перезаписываем файлы, а переходим в копию нужной ветки
+        if (getSetting("branch_switch_mode") == "worktree") {
+            std::string worktreePath = acquireWorktree(workDir, wstringToString(branchName));
+            if (!worktreePath.empty()) {
+                invalidateRefIndex(workDir);
+                changeWorkingDirectory(worktreePath);
+                std::wcout << L"Текущая ветка: " << branchName << L"\n";
+            }
             return;
         }
         
@@ -1433,6 +9004,7 @@ public:
             result = executeCommandInDirectory(cmd, workDir);
         }
         
+        invalidateRefIndex(workDir);
         std::wcout << stringToWstring(result) << L"\n";
     }
 
@@ -1615,15 +9187,10 @@ public:
         std::wcin.ignore();
         
         if (pushChoice == L'д' || pushChoice == L'Д') {
-            std::string pushCmd = "git push";
-            result = executeCommand(pushCmd);
-            std::wcout << stringToWstring(result) << L"\n";
-            
-            if (result.find("error") != std::string::npos || result.find("fatal") != std::string::npos) {
-                std::wcout << L"Произошла ошибка при отправке изменений на GitHub.\n";
-            } else {
-                std::wcout << L"Файлы успешно загружены в репозиторий и отправлены на GitHub!\n";
-            }
+            std::wcout << L"Файлы успешно загружены в локальный репозиторий.\n";
+            startJob(L"Отправка загруженных файлов", "", [this](Job& job, const std::string& workDir) {
+                return runJobCommand(job, "git push --progress", workDir) == 0;
+            });
         } else {
             std::wcout << L"Файлы успешно загружены в локальный репозиторий!\n";
         }
@@ -1660,6 +9227,18 @@ public:
             return;
         }
         
+        // В режиме пула рабочих копий новая ветка создается в отдельной рабочей копии от текущего коммита
+        if (getSetting("branch_switch_mode") == "worktree") {
+            std::string headSha = trimString(executeCommandInWorkDir("git rev-parse HEAD", workDir));
+            std::string worktreePath = acquireWorktree(workDir, wstringToString(branchName), headSha);
+            invalidateRefIndex(workDir);
+            if (!worktreePath.empty()) {
+                changeWorkingDirectory(worktreePath);
+                std::wcout << L"Ветка '" << branchName << L"' создана и установлена как текущая!\n";
+            }
+            return;
+        }
+        
         std::string cmd = "git checkout -b " + wstringToString(branchName);
         std::string result;
         
@@ -1669,6 +9248,8 @@ public:
             result = executeCommandInDirectory(cmd, workDir);
         }
         
+        invalidateRefIndex(workDir);
+        
         std::wcout << stringToWstring(result) << L"\n";
         std::wcout << L"Ветка '" << branchName << L"' создана и установлена как текущая!\n";
     }
@@ -1687,23 +9268,14 @@ public:
         // Проверяем, есть ли коммиты в репозитории
         if (!hasCommits(workDir)) {
             if (!createInitialCommit(workDir)) {
-                return; // Пользователь отказался создавать коммит
-            }
-        }
-        
-        // Проверяем, есть ли несохраненные изменения
-        std::string statusCmd = "git status --porcelain";
-        std::string statusResult;
-        
-        if (workDir.empty()) {
-            statusResult = executeCommand(statusCmd);
-        } else {
-            statusResult = executeCommandInDirectory(statusCmd, workDir);
+                return; // Пользователь отказался создавать коммит
+            }
         }
         
-        if (!statusResult.empty()) {
+        // Проверяем, есть ли несохраненные изменения (полное состояние нужно только для вывода)
+        if (isWorkingTreeDirty(workDir)) {
             std::wcout << L"В репозитории есть несохраненные изменения:\n";
-            std::wcout << stringToWstring(statusResult) << L"\n";
+            printStatusSummary(getWorkingTreeStatus(workDir));
             std::wcout << L"Рекомендуется сохранить или отменить изменения перед слиянием веток.\n";
             std::wcout << L"Хотите продолжить слияние? (д/н): ";
             
@@ -1730,67 +9302,31 @@ public:
         currentBranch.erase(currentBranch.find_last_not_of("\r\n") + 1);
         std::wcout << L"Текущая ветка: " << stringToWstring(currentBranch) << L"\n";
         
-        // Показать список веток
-        std::string branchesCmd = "git branch";
-        std::string branches;
-        
-        if (workDir.empty()) {
-            branches = executeCommand(branchesCmd);
-        } else {
-            branches = executeCommandInDirectory(branchesCmd, workDir);
-        }
-        
-        std::wcout << L"Доступные ветки:\n" << stringToWstring(branches) << L"\n";
-        
-        // Показать удаленные ветки
-        std::string remoteBranchesCmd = "git branch -r";
-        std::string remoteBranches;
-        
-        if (workDir.empty()) {
-            remoteBranches = executeCommand(remoteBranchesCmd);
-        } else {
-            remoteBranches = executeCommandInDirectory(remoteBranchesCmd, workDir);
-        }
-        
-        if (!remoteBranches.empty() && remoteBranches.find_first_not_of("\r\n\t ") != std::string::npos) {
-            std::wcout << L"Удаленные ветки:\n" << stringToWstring(remoteBranches) << L"\n";
-        }
-        
         // Запрашиваем ветку для слияния
-        std::wstring sourceBranch;
-        std::wcout << L"Введите имя ветки для слияния с текущей (или 'home' для возврата в меню): ";
-        std::getline(std::wcin, sourceBranch);
+        bool isRemoteBranch = false;
+        std::wstring sourceBranch = pickBranch(workDir, L"Выберите ветку для слияния с текущей", true, &isRemoteBranch);
         
-        if (checkForHomeCommand(sourceBranch)) {
-            return;
+        if (sourceBranch.empty()) {
+            return; // Пользователь отменил выбор
         }
         
-        if (sourceBranch.empty()) {
-            std::wcout << L"Имя ветки не может быть пустым!\n";
-            return;
+        // Удаленную ветку без локальной копии передаем по короткому имени,
+        // чтобы предложить создать локальную ветку
+        if (isRemoteBranch) {
+            std::string shortName = wstringToString(sourceBranch.substr(sourceBranch.find(L'/') + 1));
+            if (getLocalBranchHeads(workDir).count(shortName) == 0) {
+                sourceBranch = stringToWstring(shortName);
+            }
         }
         
         // Проверяем, существует ли указанная ветка
-        std::string branchExistsCmd = "git rev-parse --verify " + wstringToString(sourceBranch) + " 2>nul";
-        std::string branchExistsResult;
-        
-        if (workDir.empty()) {
-            branchExistsResult = executeCommand(branchExistsCmd);
-        } else {
-            branchExistsResult = executeCommandInDirectory(branchExistsCmd, workDir);
-        }
+        std::string branchExistsCmd = "git rev-parse --verify --quiet " + wstringToString(sourceBranch);
         
-        if (branchExistsResult.empty()) {
+        if (!runCommand(branchExistsCmd, workDir, false).succeeded()) {
             // Проверяем, может быть это удаленная ветка
-            branchExistsCmd = "git rev-parse --verify origin/" + wstringToString(sourceBranch) + " 2>nul";
-            
-            if (workDir.empty()) {
-                branchExistsResult = executeCommand(branchExistsCmd);
-            } else {
-                branchExistsResult = executeCommandInDirectory(branchExistsCmd, workDir);
-            }
+            branchExistsCmd = "git rev-parse --verify --quiet origin/" + wstringToString(sourceBranch);
             
-            if (branchExistsResult.empty()) {
+            if (!runCommand(branchExistsCmd, workDir, false).succeeded()) {
                 std::wcout << L"Ветка '" << sourceBranch << L"' не существует!\n";
                 return;
             } else {
@@ -1812,6 +9348,7 @@ public:
                     }
                     
                     std::wcout << stringToWstring(createLocalResult) << L"\n";
+                    invalidateRefIndex(workDir);
                     
                     // Теперь нужно переключиться обратно на исходную ветку
                     std::string switchBackCmd = "git checkout " + currentBranch;
@@ -1866,16 +9403,16 @@ public:
         std::wcout << L"Выполняется слияние ветки '" << sourceBranch << L"' в '" 
                   << stringToWstring(currentBranch) << L"'...\n";
         
-        std::string result;
-        if (workDir.empty()) {
-            result = executeCommand(mergeCmd);
-        } else {
-            result = executeCommandInDirectory(mergeCmd, workDir);
-        }
+        CommandResult mergeResult = runCommand(mergeCmd, workDir);
+        std::wcout << stringToWstring(mergeResult.output) << L"\n";
         
-        std::wcout << stringToWstring(result) << L"\n";
+        // Конфликт определяется по состоянию рабочей копии, а не по тексту вывода
+        bool hasConflicts = !mergeResult.succeeded() && getWorkingTreeStatus(workDir).conflicted > 0;
+        std::string result;
         
-        if (result.find("CONFLICT") != std::string::npos) {
+        if (!mergeResult.succeeded() && !hasConflicts) {
+            std::wcout << L"Слияние не выполнено. Проверьте вывод выше.\n";
+        } else if (hasConflicts) {
             std::wcout << L"Возникли конфликты при слиянии!\n";
             std::wcout << L"Выберите действие:\n";
             std::wcout << L"1. Отменить слияние\n";
@@ -2013,38 +9550,12 @@ public:
         }
         
         // Проверяем, настроен ли удаленный репозиторий
-        std::string remoteCmd = "git remote -v";
-        std::string remoteResult;
-        
-        if (workDir.empty()) {
-            remoteResult = executeCommand(remoteCmd);
-        } else {
-            remoteResult = executeCommandInDirectory(remoteCmd, workDir);
-        }
-        
-        bool hasRemote = !(remoteResult.empty() || remoteResult.find("origin") == std::string::npos);
-        
-        // Показать список веток
-        std::string branches;
-        if (workDir.empty()) {
-            branches = executeCommand("git branch");
-        } else {
-            branches = executeCommandInDirectory("git branch", workDir);
-        }
-        
-        std::wcout << L"Доступные ветки:\n" << stringToWstring(branches) << L"\n";
-        
-        std::wstring branchName;
-        std::wcout << L"Введите имя ветки для удаления (или 'home' для возврата в меню): ";
-        std::getline(std::wcin, branchName);
+        bool hasOrigin = hasRemote("origin", workDir);
         
-        if (checkForHomeCommand(branchName)) {
-            return;
-        }
+        std::wstring branchName = pickBranch(workDir, L"Выберите ветку для удаления", false);
         
         if (branchName.empty()) {
-            std::wcout << L"Имя ветки не может быть пустым!\n";
-            return;
+            return; // Пользователь отменил выбор
         }
         
         // Проверить, не является ли ветка текущей
@@ -2092,18 +9603,14 @@ public:
         
         std::string deleteFlag = (choice == 2) ? "-D" : "-d";
         std::string cmd = "git branch " + deleteFlag + " " + wstringToString(branchName);
-        std::string result;
+        CommandResult deleteResult = runCommand(cmd, workDir);
         
-        if (workDir.empty()) {
-            result = executeCommand(cmd);
-        } else {
-            result = executeCommandInDirectory(cmd, workDir);
-        }
+        invalidateRefIndex(workDir);
         
-        std::wcout << stringToWstring(result) << L"\n";
+        std::wcout << stringToWstring(deleteResult.output) << L"\n";
         
         // Если ветка успешно удалена локально и есть удаленный репозиторий, спрашиваем про удаление на GitHub
-        if (result.find("error") == std::string::npos && result.find("fatal") == std::string::npos && hasRemote) {
+        if (deleteResult.succeeded() && hasOrigin) {
             std::wcout << L"Хотите удалить ветку на GitHub? (д/н): ";
             wchar_t remoteChoice;
             std::wcin >> remoteChoice;
@@ -2111,15 +9618,14 @@ public:
             
             if (remoteChoice == L'д' || remoteChoice == L'Д') {
                 std::string pushCmd = "git push origin --delete " + wstringToString(branchName);
+                CommandResult pushResult = runCommand(pushCmd, workDir);
                 
-                if (workDir.empty()) {
-                    result = executeCommand(pushCmd);
+                std::wcout << stringToWstring(pushResult.output) << L"\n";
+                if (pushResult.succeeded()) {
+                    std::wcout << L"Ветка удалена на GitHub!\n";
                 } else {
-                    result = executeCommandInDirectory(pushCmd, workDir);
+                    std::wcout << L"Не удалось удалить ветку на GitHub.\n";
                 }
-                
-                std::wcout << stringToWstring(result) << L"\n";
-                std::wcout << L"Ветка удалена на GitHub!\n";
             }
         }
     }
@@ -2129,6 +9635,9 @@ public:
         int choice;
         std::wstring input;
         do {
+            applySessionCheck(false);
+            printJobNotices();
+            updatePrefetchTargets();
             std::wcout << L"\n===== Меню GitHub Manager =====" << std::endl;
             std::wcout << L"1. Создать полный проект (репозиторий + локальный проект)" << std::endl;
             std::wcout << L"2. Создать репозиторий GitHub" << std::endl;
@@ -2159,11 +9668,26 @@ public:
             std::wcout << L"26. Отправить ветку на GitHub" << std::endl;
             std::wcout << L"27. Посмотреть историю ветки" << std::endl;
             std::wcout << L"28. Переименовать ветку" << std::endl;
+            std::wcout << L"29. Отправить несколько веток на GitHub" << std::endl;
+            std::wcout << L"\n30. Настройки" << std::endl;
+            std::wcout << L"31. Фоновые задачи" << std::endl;
+            std::wcout << L"\n32. Импорт задач (issue) из CSV/JSON" << std::endl;
+            std::wcout << L"33. Задачи и pull request (локальная копия, поиск)" << std::endl;
+            std::wcout << L"34. Создать проекты по манифесту" << std::endl;
+            std::wcout << L"35. Клонировать несколько репозиториев" << std::endl;
+            std::wcout << L"36. Репозитории рабочего пространства" << std::endl;
+            std::wcout << L"37. Сводка состояния рабочего пространства" << std::endl;
             std::wcout << L"\n0. Выход" << std::endl;
             std::wcout << L"Выберите опцию: ";
             
             std::getline(std::wcin, input);
             
+            // Ctrl-C во время ввода переводит поток в состояние ошибки
+            if (std::wcin.fail() && !std::wcin.eof()) {
+                std::wcin.clear();
+                continue;
+            }
+            
             // Проверка на ввод "home" или подобное
             if (checkForHomeCommand(input)) {
                 continue; // Просто показываем меню снова
@@ -2178,6 +9702,7 @@ public:
             
             switch (choice) {
                 case 0:
+                    finishJobsBeforeExit();
                     std::wcout << L"Выход из программы...\n";
                     break;
                 case 1:
@@ -2264,6 +9789,33 @@ public:
                 case 28:
                     renameBranch();
                     break;
+                case 29:
+                    pushMultipleBranches();
+                    break;
+                case 30:
+                    showSettingsMenu();
+                    break;
+                case 31:
+                    showJobsMenu();
+                    break;
+                case 32:
+                    importIssues();
+                    break;
+                case 33:
+                    browseIssues();
+                    break;
+                case 34:
+                    scaffoldProjects();
+                    break;
+                case 35:
+                    bulkClone();
+                    break;
+                case 36:
+                    showWorkspace();
+                    break;
+                case 37:
+                    showDashboard();
+                    break;
                 default:
                     std::wcout << L"Неверный выбор. Пожалуйста, выберите опцию из меню.\n";
             }
@@ -2311,24 +9863,354 @@ public:
             branchName = stringToWstring(currentBranch);
         }
         
-        std::wcout << L"Выполняется отправка ветки '" << branchName << L"' на GitHub...\n";
-        
-        std::string cmd = "git push -u origin " + wstringToString(branchName);
-        std::string result;
+        std::string branch = trimString(wstringToString(branchName));
+        PushCheck check = checkBranchPush("origin", branch, branch, workDir);
+        if (check.upToDate()) {
+            setBranchUpstream(branch, "origin", workDir);
+            std::wcout << L"Ветка '" << branchName << L"' на GitHub уже совпадает с локальной, отправка не требуется.\n";
+            return;
+        }
         
-        if (workDir.empty()) {
-            result = executeCommand(cmd);
+        std::string cmd = "git push --progress -u origin \"" + branch + "\"";
+        startJob(L"Отправка ветки " + branchName, workDir, [this, cmd, check, branch](Job& job, const std::string& jobDir) {
+            bool succeeded = runJobCommand(job, cmd, jobDir) == 0;
+            recordPush(check, branch, branch, succeeded, jobDir);
+            return succeeded;
+        });
+    }
+
+    // Отправить несколько веток на GitHub одной операцией push
+    void pushMultipleBranches() {
+        std::string workDir = "";
+
+        if (!isGitRepository()) {
+            workDir = requestGitDirectory();
+            if (workDir.empty()) {
+                return; // Пользователь отменил операцию или ввел 'home'
+            }
+        }
+
+        // Проверяем, есть ли коммиты в репозитории
+        if (!hasCommits(workDir)) {
+            if (!createInitialCommit(workDir)) {
+                return; // Пользователь отказался создавать коммит
+            }
+        }
+
+        std::map<std::string, std::string> localHeads = getLocalBranchHeads(workDir);
+        if (localHeads.empty()) {
+            std::wcout << L"Локальные ветки не найдены.\n";
+            return;
+        }
+
+        std::wcout << L"Выберите ветки для отправки:\n";
+        std::wcout << L"1. Указать список веток\n";
+        std::wcout << L"2. Указать шаблон (например, feature/*)\n";
+        std::wcout << L"3. Все ветки с неотправленными коммитами\n";
+        std::wcout << L"Ваш выбор (или 'home' для отмены): ";
+
+        std::wstring choiceStr;
+        std::getline(std::wcin, choiceStr);
+
+        if (checkForHomeCommand(choiceStr)) {
+            return;
+        }
+
+        int choice;
+        try {
+            choice = std::stoi(choiceStr);
+        } catch (const std::exception&) {
+            std::wcout << L"Неверный ввод. Отмена операции.\n";
+            return;
+        }
+
+        std::vector<std::string> candidates;
+
+        if (choice == 1) {
+            std::wcout << L"Доступные ветки:\n";
+            for (const auto& head : localHeads) {
+                std::wcout << L"  " << stringToWstring(head.first) << L"\n";
+            }
+
+            std::wcout << L"Введите имена веток через пробел или запятую (или 'home' для отмены): ";
+            std::wstring branchList;
+            std::getline(std::wcin, branchList);
+
+            if (checkForHomeCommand(branchList)) {
+                return;
+            }
+
+            std::string listStr = wstringToString(branchList);
+            std::replace(listStr.begin(), listStr.end(), ',', ' ');
+            std::istringstream stream(listStr);
+            std::string name;
+
+            while (stream >> name) {
+                if (localHeads.count(name) == 0) {
+                    std::wcout << L"Игнорирование несуществующей ветки: " << stringToWstring(name) << L"\n";
+                } else if (std::find(candidates.begin(), candidates.end(), name) == candidates.end()) {
+                    candidates.push_back(name);
+                }
+            }
+        } else if (choice == 2) {
+            std::wcout << L"Введите шаблон имени ветки (или 'home' для отмены): ";
+            std::wstring pattern;
+            std::getline(std::wcin, pattern);
+
+            if (checkForHomeCommand(pattern)) {
+                return;
+            }
+
+            std::string patternStr = trimString(wstringToString(pattern));
+            for (const auto& head : localHeads) {
+                if (matchesGlob(head.first, patternStr)) {
+                    candidates.push_back(head.first);
+                }
+            }
+        } else if (choice == 3) {
+            for (const auto& head : localHeads) {
+                candidates.push_back(head.first);
+            }
         } else {
-            result = executeCommandInDirectory(cmd, workDir);
+            std::wcout << L"Неверный выбор.\n";
+            return;
         }
-        
-        std::wcout << stringToWstring(result) << L"\n";
-        
-        if (result.find("error") != std::string::npos || result.find("fatal") != std::string::npos) {
-            std::wcout << L"Произошла ошибка при отправке ветки!\n";
+
+        if (candidates.empty()) {
+            std::wcout << L"Не найдено ни одной подходящей ветки.\n";
+            return;
+        }
+
+        // Получаем состояние удаленного репозитория один раз для всех веток
+        std::wcout << L"Получение списка веток на GitHub...\n";
+        bool reachable = false;
+        std::map<std::string, std::string> remoteHeads = getRemoteBranchHeads("origin", workDir, &reachable);
+        if (!reachable) {
+            std::wcout << L"Не удалось получить список веток на GitHub, все выбранные ветки будут отправлены.\n";
+        }
+
+        std::vector<std::string> branchesToPush;
+        for (const auto& name : candidates) {
+            auto remoteIt = remoteHeads.find(name);
+            std::string remoteSha = (remoteIt != remoteHeads.end()) ? remoteIt->second : "";
+
+            if (remoteSha == localHeads[name]) {
+                std::wcout << L"  " << stringToWstring(name) << L" - совпадает с GitHub, пропускается\n";
+            } else if (choice == 3 && !hasUnpushedCommits(localHeads[name], remoteSha, workDir)) {
+                std::wcout << L"  " << stringToWstring(name) << L" - нет неотправленных коммитов, пропускается\n";
+            } else {
+                std::wcout << L"  " << stringToWstring(name)
+                          << (remoteSha.empty() ? L" - новая ветка\n" : L" - есть изменения\n");
+                branchesToPush.push_back(name);
+            }
+        }
+
+        if (branchesToPush.empty()) {
+            std::wcout << L"Все выбранные ветки уже актуальны на GitHub. Отправлять нечего.\n";
+            return;
+        }
+
+        std::wcout << L"Будет отправлено веток: " << branchesToPush.size() << L". Продолжить? (д/н): ";
+        wchar_t confirmChoice;
+        std::wcin >> confirmChoice;
+        std::wcin.ignore();
+
+        if (confirmChoice != L'д' && confirmChoice != L'Д') {
+            std::wcout << L"Операция отменена.\n";
+            return;
+        }
+
+        std::string branchArgs;
+        for (const auto& name : branchesToPush) {
+            branchArgs += " \"" + name + "\"";
+        }
+
+        // Одно соединение для всех веток; --atomic гарантирует, что обновятся либо все ветки, либо ни одна
+        std::string cmd = "git push --atomic --porcelain -u origin" + branchArgs;
+        CommandResult result = runCommand(cmd, workDir);
+
+        if (!result.succeeded() && result.output.find("does not support --atomic") != std::string::npos) {
+            std::wcout << L"GitHub не поддерживает атомарную отправку для этого репозитория.\n";
+            std::wcout << L"Отправить ветки без гарантии атомарности? (д/н): ";
+            wchar_t fallbackChoice;
+            std::wcin >> fallbackChoice;
+            std::wcin.ignore();
+
+            if (fallbackChoice != L'д' && fallbackChoice != L'Д') {
+                std::wcout << L"Операция отменена.\n";
+                return;
+            }
+
+            cmd = "git push --porcelain -u origin" + branchArgs;
+            result = runCommand(cmd, workDir);
+        }
+
+        std::wcout << stringToWstring(result.output) << L"\n";
+
+        // Разбираем машиночитаемый вывод: "<флаг>\t<откуда>:<куда>\t<итог>"
+        int pushedCount = 0;
+        int upToDateCount = 0;
+        int rejectedCount = 0;
+        std::istringstream stream(result.output);
+        std::string line;
+
+        while (std::getline(stream, line)) {
+            if (line.size() < 2 || line[1] != '\t') {
+                continue;
+            }
+            if (line[0] == '!') {
+                rejectedCount++;
+            } else if (line[0] == '=') {
+                upToDateCount++; // Ветка уже совпадала с удаленной - отправки не было
+            } else if (std::string(" *+-").find(line[0]) != std::string::npos) {
+                pushedCount++; // ' ' - перемотка вперед, '*' - новая ветка, '+' - принудительно, '-' - удаление
+            }
+        }
+
+        std::string url = getRemoteUrl("origin", workDir);
+        if (!result.succeeded() || rejectedCount > 0) {
+            remoteRefCache.invalidate(url);
+            std::wcout << L"Произошла ошибка при отправке веток! Отклонено: " << rejectedCount << L"\n";
+        } else {
+            std::map<std::string, std::string> pushed;
+            for (const auto& name : branchesToPush) {
+                pushed[name] = localHeads[name];
+            }
+            remoteRefCache.update(url, pushed);
+            std::wcout << L"Успешно отправлено веток: " << pushedCount << L"\n";
+            if (upToDateCount > 0) {
+                std::wcout << L"Уже актуальны на GitHub: " << upToDateCount << L"\n";
+            }
+        }
+    }
+
+    // Показать и изменить настройки
+    void showSettingsMenu() {
+        const std::vector<SettingInfo>& infos = getSettingInfos();
+
+        std::wcout << L"Настройки:\n";
+        for (size_t i = 0; i < infos.size(); i++) {
+            std::wcout << (i + 1) << L". " << infos[i].description << L"\n"
+                      << L"   " << stringToWstring(infos[i].key) << L" = " << stringToWstring(getSetting(infos[i].key)) << L"\n";
+        }
+
+        std::wcout << L"Введите номер настройки для изменения (или 'home' для возврата в меню): ";
+        std::wstring choiceStr;
+        std::getline(std::wcin, choiceStr);
+
+        if (checkForHomeCommand(choiceStr) || choiceStr.empty()) {
+            return;
+        }
+
+        size_t choice;
+        try {
+            choice = static_cast<size_t>(std::stoi(choiceStr));
+        } catch (const std::exception&) {
+            std::wcout << L"Неверный ввод.\n";
+            return;
+        }
+
+        if (choice < 1 || choice > infos.size()) {
+            std::wcout << L"Неверный выбор.\n";
+            return;
+        }
+
+        const SettingInfo& info = infos[choice - 1];
+        std::wcout << L"Новое значение для " << stringToWstring(info.key) << L" (пусто - по умолчанию): ";
+        std::wstring value;
+        std::getline(std::wcin, value);
+
+        if (checkForHomeCommand(value)) {
+            return;
+        }
+
+        if (value.empty()) {
+            settings.erase(info.key);
         } else {
-            std::wcout << L"Ветка '" << branchName << L"' успешно отправлена на GitHub!\n";
+            settings[info.key] = trimString(wstringToString(value));
+        }
+
+        saveSettings();
+        applyRuntimeSettings();
+        if (info.key == "api_base_url") {
+            // Новый адрес - новый клиент; токен и пользователь проверяются заново
+            apiClient.reset();
+            isAuthenticated = false;
+        }
+        std::wcout << L"Настройка сохранена: " << stringToWstring(info.key) << L" = "
+                  << stringToWstring(getSetting(info.key)) << L"\n";
+    }
+    
+    // Показать фоновые задачи и управлять ими
+    void showJobsMenu() {
+        while (true) {
+            std::vector<std::shared_ptr<Job>> jobs = jobManager ? jobManager->list() : std::vector<std::shared_ptr<Job>>();
+            if (jobs.empty()) {
+                std::wcout << L"Фоновых задач нет.\n";
+                return;
+            }
+
+            std::wcout << L"\n  #  Состояние     Прогресс  Время     Задача\n";
+            for (const auto& job : jobs) {
+                std::wstring progress = job->getProgress() >= 0 ? std::to_wstring(job->getProgress()) + L"%" : L"-";
+                std::wcout << std::setw(3) << job->id << L"  " << std::left << std::setw(12) << jobStateName(job->getState())
+                          << L"  " << std::setw(8) << progress << L"  " << std::setw(8)
+                          << (std::to_wstring(static_cast<int>(job->elapsedSeconds())) + L" с") << std::right
+                          << L"  " << job->title << L"\n"
+                          << L"     " << stringToWstring(job->repository);
+                std::string phase = job->getPhase();
+                if (!job->isFinished() && !phase.empty()) {
+                    std::wcout << L" [" << stringToWstring(phase) << L"]";
+                }
+                std::wcout << L"\n";
+            }
+
+            std::wcout << L"Команда (w N - дождаться, c N - отменить, l N - журнал, Enter - в меню): ";
+            std::wstring command;
+            std::getline(std::wcin, command);
+            if (command.empty() || checkForHomeCommand(command)) {
+                return;
+            }
+
+            std::wistringstream stream(command);
+            std::wstring action;
+            int id = 0;
+            stream >> action >> id;
+            std::shared_ptr<Job> job = getJobManager().find(id);
+            if (!job) {
+                std::wcout << L"Задача #" << id << L" не найдена.\n";
+                continue;
+            }
+
+            if (action == L"w") {
+                waitForJob(job);
+            } else if (action == L"c") {
+                job->requestCancel();
+                std::wcout << L"Отмена задачи #" << id << L" запрошена.\n";
+            } else if (action == L"l") {
+                std::wcout << stringToWstring(job->getLog()) << L"\n";
+            } else {
+                std::wcout << L"Неизвестная команда.\n";
+            }
+        }
+    }
+
+    // Перед выходом: дождаться незавершенных задач или отменить их
+    void finishJobsBeforeExit() {
+        if (!jobManager || jobManager->activeCount() == 0) {
+            return;
         }
+
+        std::wcout << L"Незавершенных фоновых задач: " << jobManager->activeCount()
+                  << L". Дождаться их завершения? (д/н): ";
+        std::wstring answer;
+        std::getline(std::wcin, answer);
+        bool wait = !answer.empty() && (answer[0] == L'д' || answer[0] == L'Д');
+        if (!wait) {
+            std::wcout << L"Отмена фоновых задач...\n";
+        }
+        jobManager->shutdown(!wait);
+        printJobNotices();
     }
     
     // Посмотреть историю ветки
@@ -2457,6 +10339,8 @@ public:
             result = executeCommandInDirectory(cmd, workDir);
         }
         
+        invalidateRefIndex(workDir);
+        
         if (result.empty()) {
             std::wcout << L"Ветка успешно переименована из '" << oldName << L"' в '" << newName << L"'!\n";
         } else {
@@ -2699,16 +10583,7 @@ public:
         
         if (pushChoice == L'д' || pushChoice == L'Д') {
             // Проверяем, настроен ли удаленный репозиторий
-            std::string remoteCmd = "git remote -v";
-            std::string remoteResult;
-            
-            if (workDir.empty()) {
-                remoteResult = executeCommand(remoteCmd);
-            } else {
-                remoteResult = executeCommandInDirectory(remoteCmd, workDir);
-            }
-            
-            if (remoteResult.empty() || remoteResult.find("origin") == std::string::npos) {
+            if (!hasRemote("origin", workDir)) {
                 // Удаленный репозиторий не настроен
                 std::wcout << L"Удаленный репозиторий не настроен. Хотите создать репозиторий на GitHub? (д/н): ";
                 wchar_t createRepoChoice;
@@ -2744,27 +10619,20 @@ public:
                     
                     bool isPrivate = (privateChoice == L'д' || privateChoice == L'Д');
                     
-                    // Формируем команду для создания репозитория
-                    std::string createRepoCmd = "gh repo create " + wstringToString(repoName) + 
-                                              " --" + (isPrivate ? "private" : "public") + 
-                                              " --source=. --remote=origin";
-                    
-                    std::string createRepoResult;
-                    if (workDir.empty()) {
-                        createRepoResult = executeCommand(createRepoCmd);
-                    } else {
-                        createRepoResult = executeCommandInDirectory(createRepoCmd, workDir);
+                    HttpResponse createResponse = createRemoteRepository(repoName, isPrivate);
+                    if (!createResponse.ok()) {
+                        printApiError(createResponse, L"Не удалось создать репозиторий на GitHub");
+                        return;
                     }
                     
-                    std::wcout << stringToWstring(createRepoResult) << L"\n";
-                    
-                    if (createRepoResult.find("Created repository") != std::string::npos ||
-                        createRepoResult.find("HTTP 201") != std::string::npos) {
-                        std::wcout << L"Репозиторий успешно создан на GitHub!\n";
-                    } else {
-                        std::wcout << L"Не удалось создать репозиторий на GitHub. Убедитесь, что GitHub CLI (gh) установлен и вы авторизованы.\n";
+                    JsonDocument document(createResponse.body);
+                    CommandResult addRemoteResult = runCommand("git remote add origin " + document.root()["clone_url"].asString(), workDir);
+                    if (!addRemoteResult.succeeded()) {
+                        std::wcout << stringToWstring(addRemoteResult.output) << L"\n";
+                        std::wcout << L"Не удалось добавить удаленный репозиторий.\n";
                         return;
                     }
+                    std::wcout << L"Репозиторий успешно создан на GitHub!\n";
                 } else {
                     std::wcout << L"Введите URL удаленного репозитория (или 'home' для отмены): ";
                     std::wstring remoteUrl;
@@ -2782,14 +10650,10 @@ public:
                     // Добавляем удаленный репозиторий
                     std::string addRemoteCmd = "git remote add origin " + wstringToString(remoteUrl);
                     
-                    if (workDir.empty()) {
-                        result = executeCommand(addRemoteCmd);
-                    } else {
-                        result = executeCommandInDirectory(addRemoteCmd, workDir);
-                    }
+                    CommandResult addRemoteResult = runCommand(addRemoteCmd, workDir);
                     
-                    if (!result.empty()) {
-                        std::wcout << stringToWstring(result) << L"\n";
+                    if (!addRemoteResult.succeeded()) {
+                        std::wcout << stringToWstring(addRemoteResult.output) << L"\n";
                         std::wcout << L"Не удалось добавить удаленный репозиторий.\n";
                         return;
                     }
@@ -2797,7 +10661,7 @@ public:
             }
             
             // Отправляем изменения на GitHub
-            std::string pushCmd = "git push -u origin master";
+            std::string pushCmd = "git push --progress -u origin master";
             
             // Проверяем, какая ветка текущая
             std::string currentBranchCmd = "git branch --show-current";
@@ -2812,22 +10676,12 @@ public:
             currentBranch.erase(currentBranch.find_last_not_of("\r\n") + 1);
             
             if (!currentBranch.empty() && currentBranch != "master") {
-                pushCmd = "git push -u origin " + currentBranch;
+                pushCmd = "git push --progress -u origin " + currentBranch;
             }
             
-            if (workDir.empty()) {
-                result = executeCommand(pushCmd);
-            } else {
-                result = executeCommandInDirectory(pushCmd, workDir);
-            }
-            
-            std::wcout << stringToWstring(result) << L"\n";
-            
-            if (result.find("error") != std::string::npos || result.find("fatal") != std::string::npos) {
-                std::wcout << L"Произошла ошибка при отправке изменений на GitHub.\n";
-            } else {
-                std::wcout << L"Изменения успешно отправлены на GitHub!\n";
-            }
+            startJob(L"Отправка выбранных файлов", workDir, [this, pushCmd](Job& job, const std::string& jobDir) {
+                return runJobCommand(job, pushCmd, jobDir) == 0;
+            });
         }
     }
 };